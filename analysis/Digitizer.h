@@ -0,0 +1,385 @@
+// Detector response stage for analyzeSteps: gas hits -> sparse camera images.
+//
+// Per hit:
+//   - primary ionization: n ~ Poisson(edep / W)
+//   - drift to the readout plane z = readoutZ, with attachment exp(-L/lambda)
+//   - transverse / longitudinal diffusion  sigma = D * sqrt(L), plus the
+//     optical blur added in quadrature to the transverse one
+//   - GEM gain: Polya with integer shape k (k = 1: exponential),
+//     times photons per avalanche electron and optical efficiency
+//   - photon statistics as a Gaussian sqrt(N) term
+// Per event: the electrons are binned on the camera grid (optionally in
+// drift slices), every pixel gets noise (also the empty ones, so noise-only
+// pixels survive zero suppression as on a real camera) and pixels below
+// threshold are dropped.
+//
+// The per-electron loop works on arrays of pre-drawn uniforms and has no
+// branches, so it vectorizes (with -O3 -march=native and a vector math
+// library). The random stream of every (event, rootID) cluster, and of the
+// pixel noise of every event, is seeded from (seed, eventID, rootID):
+// images do not depend on the threads or on the chunking.
+//
+// Parameters are read from a "key value" file (see digitizer.txt).
+
+#ifndef Digitizer_h
+#define Digitizer_h
+
+#include "StepsAnalysis.h"
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <map>
+#include <unordered_set>
+
+namespace steps {
+
+struct DigitizerParams {
+    // gas
+    double W         = 38e-6;   // MeV per ion pair
+    double readoutZ  = 0.;      // mm, plane the electrons drift to
+    double DT        = 0.13;    // mm/sqrt(cm), transverse diffusion
+    double DL        = 0.10;    // mm/sqrt(cm), longitudinal diffusion
+    double lambda    = 0.;      // mm, attachment length (<= 0: none)
+
+    // amplification
+    double gain      = 1.5e6;   // mean effective GEM gain
+    int    polyaK    = 1;       // Polya shape (integer, >= 1)
+    double photonsPerElectron = 0.07;
+    double opticsEff = 1.1e-4;  // geometric acceptance x QE
+
+    // camera (pixel size projected on the gas)
+    int    nx        = 740;
+    int    ny        = 740;
+    double pitch     = 0.1;     // mm
+    double blur      = 0.;      // mm, optical point spread (Gaussian)
+    int    nSlices   = 1;       // drift slices (1: integrated image)
+    double sliceDz   = 50.;     // mm, drift length per slice
+    double noise     = 0.;      // counts rms per pixel
+    double threshold = 0.;      // counts, zero suppression
+
+    std::uint64_t seed = 12345;
+
+    // photons detected per primary electron reaching the GEM
+    double MeanSignal() const { return gain * photonsPerElectron * opticsEff; }
+
+    bool Load(const std::string& file) {
+        std::ifstream in(file);
+        if (!in) {
+            std::cerr << "Cannot open digitizer parameters " << file << "\n";
+            return false;
+        }
+        const std::map<std::string, double*> dbl = {
+            {"W", &W}, {"readoutZ", &readoutZ}, {"DT", &DT}, {"DL", &DL}, {"lambda", &lambda},
+            {"gain", &gain}, {"photonsPerElectron", &photonsPerElectron}, {"opticsEff", &opticsEff},
+            {"pitch", &pitch}, {"blur", &blur}, {"sliceDz", &sliceDz},
+            {"noise", &noise}, {"threshold", &threshold}};
+        const std::map<std::string, int*> ints = {
+            {"polyaK", &polyaK}, {"nx", &nx}, {"ny", &ny}, {"nSlices", &nSlices}};
+
+        std::string line;
+        while (std::getline(in, line)) {
+            const auto hash = line.find('#');
+            if (hash != std::string::npos) line.erase(hash);
+            std::istringstream is(line);
+            std::string key;
+            if (!(is >> key)) continue;
+
+            if      (auto d = dbl.find(key);  d != dbl.end())  is >> *d->second;
+            else if (auto i = ints.find(key); i != ints.end()) is >> *i->second;
+            else if (key == "seed")                            is >> seed;
+            else {
+                std::cerr << "Unknown digitizer parameter " << key << "\n";
+                return false;
+            }
+            if (is.fail()) {
+                std::cerr << "Bad value for digitizer parameter " << key << "\n";
+                return false;
+            }
+        }
+        polyaK  = std::max(polyaK, 1);
+        nSlices = std::max(nSlices, 1);
+        return true;
+    }
+};
+
+// xoshiro256** seeded through splitmix64
+class Xoshiro {
+  public:
+    using result_type = std::uint64_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    explicit Xoshiro(std::uint64_t seed) {
+        for (auto& v : s) v = SplitMix(seed);
+    }
+
+    result_type operator()() {
+        const std::uint64_t r = Rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0]; s[3] ^= s[1]; s[1] ^= s[2]; s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = Rotl(s[3], 45);
+        return r;
+    }
+
+    // (0, 1]: safe for log()
+    double Open() { return double(((*this)() >> 11) + 1) * 0x1.0p-53; }
+
+    static std::uint64_t SplitMix(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+  private:
+    static std::uint64_t Rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    std::uint64_t s[4];
+};
+
+class DigitizerStage : public Stage {
+  public:
+    DigitizerStage(const std::string& output_name, const DigitizerParams& p)
+      : fFileName(output_name), fPar(p) {}
+
+    struct Chunk : StageChunk {
+        // output rows (one per event with hits)
+        std::vector<Int_t>   event, nRedpix;
+        std::vector<Float_t> energy;              // keV deposited
+        std::vector<size_t>  offset{0};
+        std::vector<Int_t>   ix, iy, slice;
+        std::vector<Float_t> counts;
+
+        // scratch, reused for every hit / event
+        std::vector<double> u1, u2, u3, u4, ug, ua, ex, ey, ez, sig;
+        std::vector<std::pair<Int_t, float>> pix;  // (pixel key, counts) of the current event
+        std::vector<std::pair<Int_t, float>> red;  // pixels above threshold
+        std::vector<Int_t> signal;                 // keys with signal, sorted
+        std::unordered_set<Int_t> drawn;           // noise-only keys drawn
+        double eventEdep = 0.;
+    };
+
+    std::unique_ptr<StageChunk> NewChunk() const override { return std::make_unique<Chunk>(); }
+
+    void Process(const StepsReader& r, const Cluster& c, StageChunk& base) const override {
+        auto& ch = static_cast<Chunk&>(base);
+        const auto& p = fPar;
+
+        std::uint64_t key = p.seed ^ (std::uint64_t(std::uint32_t(c.event)) << 32) ^ std::uint32_t(c.rootID);
+        Xoshiro rng(Xoshiro::SplitMix(key));
+
+        const double meanSignal = p.MeanSignal();
+        const double invK  = 1. / p.polyaK;
+        const double blur2 = p.blur * p.blur;
+        const double x0 = -0.5 * p.nx * p.pitch;
+        const double y0 = -0.5 * p.ny * p.pitch;
+
+        for (size_t k = 0; k < c.n; ++k) {
+            const size_t i = c.idx[k];
+            const double edep = (*r.edep)[i];
+            ch.eventEdep += edep;
+            if (edep <= 0.) continue;
+
+            std::poisson_distribution<int> primaries(edep / p.W);
+            const int n = primaries(rng);
+            if (n <= 0) continue;
+
+            const double hx = (*r.x)[i], hy = (*r.y)[i], hz = (*r.z)[i];
+            const double L  = std::abs(hz - p.readoutZ);          // mm
+            const double sqrtLcm = std::sqrt(0.1 * L);
+            const double sT = std::sqrt(p.DT*p.DT*sqrtLcm*sqrtLcm + blur2);
+            const double sL = p.DL * sqrtLcm;
+            const double pSurvive = (p.lambda > 0.) ? std::exp(-L / p.lambda) : 1.;
+
+            // draw all uniforms first (sequential), then transform (vectorizable)
+            for (auto* v : {&ch.u1, &ch.u2, &ch.u3, &ch.u4, &ch.ua, &ch.ex, &ch.ey, &ch.ez, &ch.sig})
+                v->resize(n);
+            ch.ug.assign(n, 1.);
+            for (int e = 0; e < n; ++e) {
+                ch.u1[e] = rng.Open(); ch.u2[e] = rng.Open();
+                ch.u3[e] = rng.Open(); ch.u4[e] = rng.Open();
+                ch.ua[e] = rng.Open();
+            }
+            for (int g = 0; g < p.polyaK; ++g)
+                for (int e = 0; e < n; ++e) ch.ug[e] *= rng.Open();
+
+            const double* u1 = ch.u1.data(); const double* u2 = ch.u2.data();
+            const double* u3 = ch.u3.data(); const double* u4 = ch.u4.data();
+            const double* ug = ch.ug.data(); const double* ua = ch.ua.data();
+            double* ex = ch.ex.data(); double* ey = ch.ey.data();
+            double* ez = ch.ez.data(); double* sig = ch.sig.data();
+
+            for (int e = 0; e < n; ++e) {
+                // two Box-Muller pairs: (x, y) diffusion, (z diffusion, photon statistics)
+                const double r1 = std::sqrt(-2. * std::log(u1[e]));
+                const double a1 = 2. * M_PI * u2[e];
+                const double r2 = std::sqrt(-2. * std::log(u3[e]));
+                const double a2 = 2. * M_PI * u4[e];
+                ex[e] = hx + sT * r1 * std::cos(a1);
+                ey[e] = hy + sT * r1 * std::sin(a1);
+                ez[e] = L  + sL * r2 * std::cos(a2);
+
+                // Polya(k) gain as a Gamma(k) variate: -log(prod of k uniforms) / k
+                const double s = meanSignal * (-std::log(ug[e]) * invK);
+                const double alive = (ua[e] <= pSurvive) ? 1. : 0.;
+                sig[e] = alive * std::max(0., s + std::sqrt(s) * r2 * std::sin(a2));
+            }
+
+            for (int e = 0; e < n; ++e) {
+                const int ix = int(std::floor((ex[e] - x0) / p.pitch));
+                const int iy = int(std::floor((ey[e] - y0) / p.pitch));
+                const int iz = std::min(std::max(int(std::floor(ez[e] / p.sliceDz)), 0), p.nSlices - 1);
+                if (sig[e] <= 0. || ix < 0 || ix >= p.nx || iy < 0 || iy >= p.ny) continue;
+                ch.pix.emplace_back((iz*p.ny + iy)*p.nx + ix, float(sig[e]));
+            }
+        }
+    }
+
+    void EndOfEntry(const StepsReader& r, StageChunk& base) const override {
+        auto& ch = static_cast<Chunk&>(base);
+        const auto& p = fPar;
+        const int event = (*r.eventID)[0];
+
+        // merge the deposits of the same pixel
+        std::sort(ch.pix.begin(), ch.pix.end(),
+                  [](const auto& a, const auto& b){ return a.first < b.first; });
+
+        std::uint64_t key = p.seed ^ (std::uint64_t(std::uint32_t(event)) << 32) ^ 0xffffffffULL;
+        Xoshiro rng(Xoshiro::SplitMix(key));
+        std::normal_distribution<double> gaus(0., 1.);
+
+        // pixels with signal: summed deposit plus noise
+        auto& red = ch.red;
+        red.clear();
+        for (size_t a = 0; a < ch.pix.size();) {
+            size_t b = a;
+            double sum = 0.;
+            for (; b < ch.pix.size() && ch.pix[b].first == ch.pix[a].first; ++b) sum += ch.pix[b].second;
+            if (p.noise > 0.) sum += p.noise * gaus(rng);
+            if (sum > p.threshold) red.emplace_back(ch.pix[a].first, float(sum));
+            ch.signal.push_back(ch.pix[a].first);
+            a = b;
+        }
+
+        // empty pixels: noise alone can pass the threshold too
+        if (p.noise > 0.) AddNoisePixels(ch, rng);
+        std::sort(red.begin(), red.end(),
+                  [](const auto& x, const auto& y){ return x.first < y.first; });
+
+        for (const auto& [k, counts] : red) {
+            ch.ix.push_back(k % p.nx);
+            ch.iy.push_back((k / p.nx) % p.ny);
+            ch.slice.push_back(k / (p.nx*p.ny));
+            ch.counts.push_back(counts);
+        }
+        const int nRed = int(red.size());
+
+        ch.event.push_back(event);
+        ch.nRedpix.push_back(nRed);
+        ch.energy.push_back(float(ch.eventEdep * 1000.));
+        ch.offset.push_back(ch.ix.size());
+
+        ch.pix.clear();
+        ch.signal.clear();
+        ch.eventEdep = 0.;
+    }
+
+    void Book() override {
+        fFile = new TFile(fFileName.c_str(), "RECREATE");
+        fTree = new TTree("event_info", "Digitized camera images (sparse)");
+
+        fTree->Branch("eventnumber",  &fEvent);
+        fTree->Branch("energy",       &fEnergy);
+        fTree->Branch("nRedpix",      &fNRedpix);
+        fTree->Branch("redpix_ix",    &fIx);
+        fTree->Branch("redpix_iy",    &fIy);
+        fTree->Branch("redpix_iz",    &fCounts);
+        fTree->Branch("redpix_slice", &fSlice);
+    }
+
+    void Write(StageChunk& base) override {
+        auto& in = static_cast<Chunk&>(base);
+        for (size_t r = 0; r < in.event.size(); ++r) {
+            const size_t b = in.offset[r], e = in.offset[r+1];
+            fEvent   = in.event[r];
+            fEnergy  = in.energy[r];
+            fNRedpix = in.nRedpix[r];
+            fIx.assign(in.ix.begin() + b, in.ix.begin() + e);
+            fIy.assign(in.iy.begin() + b, in.iy.begin() + e);
+            fSlice.assign(in.slice.begin() + b, in.slice.begin() + e);
+            fCounts.assign(in.counts.begin() + b, in.counts.begin() + e);
+            fTree->Fill();
+            ++fNFilled;
+        }
+    }
+
+    void Close() override {
+        fFile->cd();
+        fTree->Write();
+        fFile->Close();
+        std::cout << "Wrote " << fNFilled << " digitized events to " << fFileName << std::endl;
+    }
+
+  private:
+    // Noise-only pixels above threshold among the pixels without signal.
+    // Drawing noise for every pixel of the grid would cost ~nx*ny draws
+    // per event; instead their number is drawn (binomial, p = P(noise >
+    // threshold)), then their keys uniformly, then their values from the
+    // Gaussian tail. Same distribution, cost ~ the number kept. With a
+    // threshold near or below 0 most pixels pass and the grid is walked.
+    void AddNoisePixels(Chunk& ch, Xoshiro& rng) const {
+        const auto& p = fPar;
+        const auto& signal = ch.signal;
+        auto& red = ch.red;
+        const long long nPix   = (long long)p.nx * p.ny * p.nSlices;
+        const long long nEmpty = nPix - (long long)signal.size();
+        const double t = p.threshold / p.noise;
+        const double q = 0.5 * std::erfc(t / std::sqrt(2.));
+        auto isSignal = [&signal](Int_t k) {
+            return std::binary_search(signal.begin(), signal.end(), k);
+        };
+
+        if (q > 0.1) {
+            std::normal_distribution<double> gaus(0., 1.);
+            for (long long k = 0; k < nPix; ++k) {
+                if (isSignal(Int_t(k))) continue;
+                const double v = p.noise * gaus(rng);
+                if (v > p.threshold) red.emplace_back(Int_t(k), float(v));
+            }
+            return;
+        }
+
+        const long long n = std::binomial_distribution<long long>(nEmpty, q)(rng);
+        if (n == 0) return;
+        std::uniform_int_distribution<long long> pick(0, nPix - 1);
+        std::uniform_real_distribution<double> u(0., 1.);
+        const double alpha = 0.5 * (t + std::sqrt(t*t + 4.));   // Robert (1995)
+        auto& drawn = ch.drawn;
+        drawn.clear();
+        for (long long i = 0; i < n; ++i) {
+            Int_t k;
+            do { k = Int_t(pick(rng)); } while (isSignal(k) || !drawn.insert(k).second);
+            double z;
+            do { z = t - std::log(1. - u(rng)) / alpha; }
+            while (u(rng) > std::exp(-0.5 * (z - alpha) * (z - alpha)));
+            red.emplace_back(k, float(p.noise * z));
+        }
+    }
+
+    std::string     fFileName;
+    DigitizerParams fPar;
+    TFile*          fFile = nullptr;
+    TTree*          fTree = nullptr;
+    int             fNFilled = 0;
+
+    Int_t   fEvent = -1, fNRedpix = 0;
+    Float_t fEnergy = 0.f;
+    std::vector<Int_t>   fIx, fIy, fSlice;
+    std::vector<Float_t> fCounts;
+};
+
+} // namespace steps
+
+#endif // Digitizer_h
@@ -0,0 +1,617 @@
+// Single-pass analysis of the simulation 'steps' tree.
+//
+// The driver reads each entry once (from a TChain, wildcards allowed),
+// joins the consecutive entries of an event spilled over several entries
+// (/B3/output/overflow spill: same eventID, same file) into one event,
+// groups the hits of the event by primary ancestor (rootID), sorts every
+// group by time and evaluates the containment geometry once. The clusters
+// are then passed to every registered output Stage.
+//
+// Chunks of entries are processed on worker threads; each stage fills a
+// per-chunk buffer there, and the main thread hands the buffers back to
+// the stages in entry order, so the outputs do not depend on the number
+// of threads.
+//
+// Adding a stage: derive from Stage, implement NewChunk / Process (worker
+// threads, must not touch shared state) and Book / Write / Close (main
+// thread), then add it to the list passed to RunStages.
+
+#ifndef StepsAnalysis_h
+#define StepsAnalysis_h
+
+#include <TFile.h>
+#include <TTree.h>
+#include <TChain.h>
+#include <TROOT.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace steps {
+
+// =========================
+// Geometry / global constants
+// =========================
+const double InnerSourceContThick = 5;
+const double GasRadius            = 36.9; // mm
+const double GasDistanceFromCollim= 10;
+const double CollimatorDepth      = 2;
+const double CollimatorDistance   = 0;
+const double GasThickness         = 50;
+const double containment_off      = 5; // mm
+
+// Angular acceptance around -z
+const double acceptedAngleStart = M_PI - (30*M_PI/180.0);
+const double acceptedAngleEnd   = M_PI + (30*M_PI/180.0);
+
+const double cyl_center_z = InnerSourceContThick / 2
+                          + CollimatorDepth
+                          + CollimatorDistance
+                          + GasRadius
+                          + GasDistanceFromCollim;
+
+// =========================
+// Containment check
+//
+// A point passes if it is within GasRadius - containment_off of the axis,
+// or if its direction from the axis is within +-30 deg of -z:
+//   atan2(dx, dz) in [pi - 30deg, pi + 30deg]  <=>  dz < 0 && |dx| <= tan(30deg) |dz|
+// Written without branches or atan2 so that the loop vectorizes.
+// =========================
+inline bool areAllPointsInsideCylinder(const double* x, const double* z, size_t n) {
+    const double maxR  = GasRadius - containment_off;
+    const double maxR2 = maxR*maxR;
+    const double tanHalf  = std::tan(M_PI - acceptedAngleStart);
+    const double tanHalf2 = tanHalf*tanHalf;
+
+    unsigned ok = 1;
+    for (size_t i = 0; i < n; ++i) {
+        const double dx = x[i];
+        const double dz = z[i] - cyl_center_z;
+        const double r2 = dx*dx + dz*dz;
+        const unsigned inR     = (r2 <= maxR2);
+        const unsigned inAngle = (dz < 0.) & (dx*dx <= tanHalf2*dz*dz);
+        ok &= (inR | inAngle);
+    }
+    return ok != 0;
+}
+
+// =========================
+// One entry of 'steps' (only the branches used here are read)
+// =========================
+struct StepsReader {
+    std::unique_ptr<TChain> chain;
+    std::vector<int>    *eventID=nullptr, *rootID=nullptr, *pdg=nullptr;
+    std::vector<double> *x=nullptr,*y=nullptr,*z=nullptr,*t=nullptr,*px=nullptr,*py=nullptr,*pz=nullptr,*edep=nullptr,*stepLen=nullptr;
+
+    explicit StepsReader(const std::string& input) : chain(new TChain("steps")) {
+        chain->Add(input.c_str());
+        chain->SetBranchStatus("*", 0);
+        for (const char* b : {"eventID","rootID","pdg","x","y","z","t","px","py","pz","edep","stepLen"})
+            chain->SetBranchStatus(b, 1);
+
+        chain->SetBranchAddress("eventID", &eventID);
+        chain->SetBranchAddress("rootID",  &rootID);
+        chain->SetBranchAddress("pdg",     &pdg);
+        chain->SetBranchAddress("x",&x);    chain->SetBranchAddress("y",&y);    chain->SetBranchAddress("z",&z);
+        chain->SetBranchAddress("t",&t);
+        chain->SetBranchAddress("px",&px);  chain->SetBranchAddress("py",&py);  chain->SetBranchAddress("pz",&pz);
+        chain->SetBranchAddress("edep",&edep);
+        chain->SetBranchAddress("stepLen",&stepLen);
+    }
+
+    // Read the event that starts at 'entry' into the vectors above: the
+    // entry itself plus the following entries of the same file with the
+    // same eventID (a spilled event). Returns the entry after the event.
+    Long64_t ReadEvent(Long64_t entry, Long64_t nEntries) {
+        chain->GetEntry(entry);
+        if (eventID->empty()) return entry + 1;
+        const int id   = (*eventID)[0];
+        const int tree = chain->GetTreeNumber();
+
+        Long64_t next = entry + 1;
+        int nextID = 0;
+        for (; next < nEntries && EventIDAt(next, nextID) && nextID == id
+               && chain->GetTreeNumber() == tree; ++next) {
+            Append(next);
+        }
+        eventID->assign(x->size(), id);   // EventIDAt reads over it
+        return next;
+    }
+
+    // 'entry' if an event starts there; if it continues the event of the
+    // entry before, the first entry after that event
+    Long64_t SkipContinuation(Long64_t entry, Long64_t nEntries) {
+        int id = 0, prevID = 0;
+        if (entry == 0 || !EventIDAt(entry - 1, prevID)) return entry;
+        const int tree = chain->GetTreeNumber();
+        while (entry < nEntries && EventIDAt(entry, id) && id == prevID
+               && chain->GetTreeNumber() == tree) ++entry;
+        return entry;
+    }
+
+  private:
+    // eventID of an entry, reading that branch only; false for an entry without hits
+    bool EventIDAt(Long64_t entry, int& id) {
+        const Long64_t local = chain->LoadTree(entry);
+        if (local < 0) return false;
+        chain->GetTree()->GetBranch("eventID")->GetEntry(local);
+        if (eventID->empty()) return false;
+        id = (*eventID)[0];
+        return true;
+    }
+
+    // add the hits of 'entry' after those already read
+    void Append(Long64_t entry) {
+        SwapOut();
+        chain->GetEntry(entry);
+        auto cat = [](auto& held, auto* v) {
+            held.insert(held.end(), v->begin(), v->end());
+            v->swap(held);
+        };
+        cat(fRootID, rootID); cat(fPdg, pdg);
+        cat(fX, x); cat(fY, y); cat(fZ, z); cat(fT, t);
+        cat(fPx, px); cat(fPy, py); cat(fPz, pz);
+        cat(fEdep, edep); cat(fStepLen, stepLen);
+    }
+
+    void SwapOut() {
+        fRootID.swap(*rootID); fPdg.swap(*pdg);
+        fX.swap(*x); fY.swap(*y); fZ.swap(*z); fT.swap(*t);
+        fPx.swap(*px); fPy.swap(*py); fPz.swap(*pz);
+        fEdep.swap(*edep); fStepLen.swap(*stepLen);
+    }
+
+    // hits of the entries already read while joining a spilled event
+    std::vector<int>    fRootID, fPdg;
+    std::vector<double> fX, fY, fZ, fT, fPx, fPy, fPz, fEdep, fStepLen;
+};
+
+// Hits of one (event, rootID) group, sorted by time: idx[k] indexes the
+// vectors of the StepsReader. 'contained' is the containment check of
+// all its hits.
+struct Cluster {
+    int           event = -1;
+    int           rootID = -1;
+    const size_t* idx = nullptr;
+    size_t        n = 0;
+    bool          contained = true;
+};
+
+// =========================
+// Output stage
+// =========================
+struct StageChunk {
+    virtual ~StageChunk() = default;
+};
+
+class Stage {
+  public:
+    virtual ~Stage() = default;
+
+    // main thread
+    virtual void Book() = 0;                       // open the output
+    virtual void Write(StageChunk& chunk) = 0;     // chunks arrive in entry order
+    virtual void Close() = 0;
+
+    // worker threads
+    virtual std::unique_ptr<StageChunk> NewChunk() const = 0;
+    virtual void Process(const StepsReader& ev, const Cluster& c, StageChunk& chunk) const = 0;
+    // after the last cluster of an event (for per-event outputs)
+    virtual void EndOfEntry(const StepsReader& /*ev*/, StageChunk& /*chunk*/) const {}
+};
+
+// =========================
+// Driver
+// =========================
+struct RunInfo {
+    Long64_t entries = 0;
+    double   seconds = 0.;
+};
+
+// Group the hits of the current entry of 'r' and pass every cluster to
+// the stages. 'order', 'gx', 'gz' are reused scratch buffers.
+inline void ProcessEntry(const StepsReader& r, const std::vector<Stage*>& stages,
+                         std::vector<std::unique_ptr<StageChunk>>& chunks,
+                         std::vector<size_t>& order, std::vector<double>& gx, std::vector<double>& gz) {
+    const auto& x = *r.x;
+    if (x.empty()) return; // no gas hits in this event
+
+    const auto& rootID = *r.rootID;
+    const auto& t      = *r.t;
+    const size_t n = x.size();
+
+    // Group hits by primary ancestor without a map: indices ordered by
+    // (rootID, index) give the groups in the same order, with the same
+    // index order inside each group, as std::map<int, vector<size_t>>
+    order.resize(n);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return rootID[a] < rootID[b] || (rootID[a] == rootID[b] && a < b);
+    });
+
+    Cluster c;
+    c.event = (*r.eventID)[0];
+    for (size_t g0 = 0; g0 < n;) {
+        size_t g1 = g0 + 1;
+        while (g1 < n && rootID[order[g1]] == rootID[order[g0]]) ++g1;
+
+        // Sort indices by time to keep trajectories ordered (same comparator,
+        // same input sequence as the map version -> same order, ties included)
+        std::sort(order.begin() + g0, order.begin() + g1,
+                  [&](size_t a, size_t b){ return t[a] < t[b]; });
+
+        c.rootID = rootID[order[g0]];
+        c.idx    = order.data() + g0;
+        c.n      = g1 - g0;
+
+        gx.resize(c.n);
+        gz.resize(c.n);
+        for (size_t k = 0; k < c.n; ++k) {
+            gx[k] = x[c.idx[k]];
+            gz[k] = (*r.z)[c.idx[k]];
+        }
+        c.contained = areAllPointsInsideCylinder(gx.data(), gz.data(), c.n);
+
+        for (size_t s = 0; s < stages.size(); ++s)
+            stages[s]->Process(r, c, *chunks[s]);
+        g0 = g1;
+    }
+
+    for (size_t s = 0; s < stages.size(); ++s)
+        stages[s]->EndOfEntry(r, *chunks[s]);
+}
+
+// Run all stages over the chain 'input'. Returns false if it cannot be read.
+inline bool RunStages(const std::string& input, const std::vector<Stage*>& stages,
+                      unsigned nThreads, Long64_t chunkSize, RunInfo& info) {
+    if (nThreads == 0) nThreads = 1;
+    if (chunkSize <= 0) chunkSize = 500;
+
+    ROOT::EnableThreadSafety();
+    const auto tStart = std::chrono::steady_clock::now();
+
+    Long64_t nEvents = 0;
+    {
+        TChain probe("steps");
+        if (probe.Add(input.c_str()) == 0) {
+            std::cerr << "Error opening file " << input << "\n";
+            return false;
+        }
+        nEvents = probe.GetEntries();
+        if (!probe.GetBranch("x")) {
+            std::cerr << "Error: TTree 'steps' not found in " << input << "\n";
+            return false;
+        }
+    }
+
+    for (auto* s : stages) s->Book();
+
+    // Chunks: converted in parallel, written in order. At most
+    // maxInFlight chunks are held in memory at a time.
+    using ChunkSet = std::vector<std::unique_ptr<StageChunk>>;
+    const Long64_t nChunks = (nEvents + chunkSize - 1) / chunkSize;
+    const Long64_t maxInFlight = 4 * Long64_t(nThreads);
+    std::vector<std::unique_ptr<ChunkSet>> chunks(nChunks);
+    std::atomic<Long64_t> nextChunk{0};
+    Long64_t written = 0;
+    std::mutex mtx;
+    std::condition_variable cvDone, cvSpace;
+
+    auto worker = [&]() {
+        StepsReader reader(input);
+        std::vector<size_t> order;
+        std::vector<double> gx, gz;
+        for (;;) {
+            const Long64_t c = nextChunk.fetch_add(1);
+            if (c >= nChunks) return;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cvSpace.wait(lock, [&]{ return c < written + maxInFlight; });
+            }
+            auto set = std::make_unique<ChunkSet>();
+            for (auto* s : stages) set->push_back(s->NewChunk());
+
+            // a chunk takes the events that start in its range; a spilled
+            // event crossing the boundary belongs to the chunk it starts in
+            const Long64_t first = c*chunkSize;
+            const Long64_t last  = std::min(nEvents, (c+1)*chunkSize);
+            Long64_t ie = reader.SkipContinuation(first, nEvents);
+            while (ie < last) {
+                ie = reader.ReadEvent(ie, nEvents);
+                ProcessEntry(reader, stages, *set, order, gx, gz);
+            }
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                chunks[c] = std::move(set);
+            }
+            cvDone.notify_one();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < nThreads; ++i) pool.emplace_back(worker);
+
+    for (Long64_t c = 0; c < nChunks; ++c) {
+        std::unique_ptr<ChunkSet> set;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cvDone.wait(lock, [&]{ return chunks[c] != nullptr; });
+            set = std::move(chunks[c]);
+        }
+        for (size_t s = 0; s < stages.size(); ++s) stages[s]->Write(*(*set)[s]);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            written = c + 1;
+        }
+        cvSpace.notify_all();
+    }
+    for (auto& th : pool) th.join();
+
+    for (auto* s : stages) s->Close();
+
+    info.entries = nEvents;
+    info.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+    return true;
+}
+
+// =========================
+// Stage: digitizer input ('nTuple', keV), one row per cluster;
+// with check_points only fully contained clusters are written
+// =========================
+class DigiStage : public Stage {
+  public:
+    DigiStage(const std::string& output_basename, bool check_points)
+      : fFileName(output_basename + ".root"), fCheck(check_points) {}
+
+    struct Chunk : StageChunk {
+        std::vector<Int_t>    event, nhits;
+        std::vector<Double_t> etotal;
+        std::vector<size_t>   offset{0};          // hits of row r: [offset[r], offset[r+1])
+        std::vector<Int_t>    pdg;
+        std::vector<Double_t> tracklen, px, py, pz, edep, x, y, z;
+    };
+
+    std::unique_ptr<StageChunk> NewChunk() const override { return std::make_unique<Chunk>(); }
+
+    void Process(const StepsReader& r, const Cluster& c, StageChunk& base) const override {
+        if (fCheck && !c.contained) return;
+        auto& out = static_cast<Chunk&>(base);
+        const double MeV_to_keV = 1000.0;
+
+        Double_t etot = 0.0;
+        for (size_t k = 0; k < c.n; ++k) {
+            const size_t i = c.idx[k];
+            out.x.push_back((*r.x)[i]);
+            out.y.push_back((*r.y)[i]);
+            out.z.push_back((*r.z)[i]);
+            out.px.push_back((*r.px)[i]);
+            out.py.push_back((*r.py)[i]);
+            out.pz.push_back((*r.pz)[i]);
+            out.pdg.push_back((*r.pdg)[i]);
+            out.tracklen.push_back((*r.stepLen)[i]);
+            const double e_keV = (*r.edep)[i] * MeV_to_keV;
+            out.edep.push_back(e_keV);
+            etot += e_keV;
+        }
+        out.event.push_back(c.event);
+        out.nhits.push_back(Int_t(c.n));
+        out.etotal.push_back(etot);
+        out.offset.push_back(out.x.size());
+    }
+
+    void Book() override {
+        fFile = new TFile(fFileName.c_str(), "RECREATE");
+        fTree = new TTree("nTuple", "nTuple");
+
+        fTree->Branch("eventnumber",     &fEvent);
+        fTree->Branch("numhits",         &fNHits);
+        fTree->Branch("energyDep",       &fETotal);
+        fTree->Branch("energyDep_NR",    &fETotalNR);
+        fTree->Branch("pdgID_hits",      &fPdg);
+        fTree->Branch("tracklen_hits",   &fTrackLen);
+        fTree->Branch("px_particle",     &fPx);
+        fTree->Branch("py_particle",     &fPy);
+        fTree->Branch("pz_particle",     &fPz);
+        fTree->Branch("energyDep_hits",  &fEdep);
+        fTree->Branch("x_hits",          &fX);
+        fTree->Branch("y_hits",          &fY);
+        fTree->Branch("z_hits",          &fZ);
+    }
+
+    void Write(StageChunk& base) override {
+        auto& in = static_cast<Chunk&>(base);
+        for (size_t r = 0; r < in.event.size(); ++r) {
+            const size_t b = in.offset[r], e = in.offset[r+1];
+            fEvent    = in.event[r];
+            fNHits    = in.nhits[r];
+            fETotal   = in.etotal[r];
+            fETotalNR = 0.0;
+            fPdg.assign(in.pdg.begin() + b, in.pdg.begin() + e);
+            fTrackLen.assign(in.tracklen.begin() + b, in.tracklen.begin() + e);
+            fPx.assign(in.px.begin() + b, in.px.begin() + e);
+            fPy.assign(in.py.begin() + b, in.py.begin() + e);
+            fPz.assign(in.pz.begin() + b, in.pz.begin() + e);
+            fEdep.assign(in.edep.begin() + b, in.edep.begin() + e);
+            fX.assign(in.x.begin() + b, in.x.begin() + e);
+            fY.assign(in.y.begin() + b, in.y.begin() + e);
+            fZ.assign(in.z.begin() + b, in.z.begin() + e);
+            fTree->Fill();
+            ++fNFilled;
+        }
+    }
+
+    void Close() override {
+        fFile->cd();
+        fTree->Write();
+        fFile->Close();
+        std::cout << "Wrote " << fNFilled << " clusters to " << fFileName << std::endl;
+    }
+
+  private:
+    std::string fFileName;
+    bool        fCheck;
+    TFile*      fFile = nullptr;
+    TTree*      fTree = nullptr;
+    int         fNFilled = 0;
+
+    Int_t    fEvent = -1, fNHits = 0;
+    Double_t fETotal = 0.0, fETotalNR = 0.0;   // keV (NR not available -> 0)
+    std::vector<Int_t>    fPdg;
+    std::vector<Double_t> fTrackLen, fPx, fPy, fPz, fEdep, fX, fY, fZ;
+};
+
+// =========================
+// Stage: reco clusters ('elabHits', MeV), one row per cluster with the
+// track length, number of primary ionizations, containment flag and the
+// dominant particle
+// =========================
+inline std::string PDGName(int pdg) {
+    switch(pdg){
+      case 11:  return "e-";
+      case -11: return "e+";
+      case 22:  return "gamma";
+      case 2212:return "proton";
+      case 2112:return "neutron";
+      default:  return std::to_string(pdg);
+    }
+}
+
+class RecoStage : public Stage {
+  public:
+    explicit RecoStage(const std::string& output_name) : fFileName(output_name) {}
+
+    struct Chunk : StageChunk {
+        std::vector<int>    event, rootID, nhits, label;
+        std::vector<double> etotal, length;
+        std::vector<char>   contained;
+        std::vector<size_t> offset{0};
+        std::vector<double> x, y, z, t, edep, px, py, pz;
+        std::vector<std::pair<int,int>> pdgCount;  // scratch (pdg, count)
+    };
+
+    std::unique_ptr<StageChunk> NewChunk() const override { return std::make_unique<Chunk>(); }
+
+    void Process(const StepsReader& r, const Cluster& c, StageChunk& base) const override {
+        auto& out = static_cast<Chunk&>(base);
+        double etot = 0.0, length = 0.0;
+        out.pdgCount.clear();
+
+        for (size_t k = 0; k < c.n; ++k) {
+            const size_t i = c.idx[k];
+            out.x.push_back((*r.x)[i]);  out.y.push_back((*r.y)[i]);  out.z.push_back((*r.z)[i]);
+            out.t.push_back((*r.t)[i]);
+            out.edep.push_back((*r.edep)[i]);
+            out.px.push_back((*r.px)[i]); out.py.push_back((*r.py)[i]); out.pz.push_back((*r.pz)[i]);
+            etot += (*r.edep)[i];
+
+            const int p = (*r.pdg)[i];
+            auto it = std::find_if(out.pdgCount.begin(), out.pdgCount.end(),
+                                   [p](const std::pair<int,int>& pc){ return pc.first == p; });
+            if (it == out.pdgCount.end()) out.pdgCount.emplace_back(p, 1);
+            else                          ++it->second;
+
+            if (k > 0) {
+                const size_t j = c.idx[k-1];
+                const double dx = (*r.x)[i]-(*r.x)[j];
+                const double dy = (*r.y)[i]-(*r.y)[j];
+                const double dz = (*r.z)[i]-(*r.z)[j];
+                length += std::sqrt(dx*dx + dy*dy + dz*dz);
+            }
+        }
+
+        // dominant PDG in the cluster (ties: lowest PDG code)
+        int bestPDG = 0, bestN = -1;
+        for (const auto& pc : out.pdgCount) {
+            if (pc.second > bestN || (pc.second == bestN && pc.first < bestPDG)) {
+                bestN = pc.second; bestPDG = pc.first;
+            }
+        }
+
+        out.event.push_back(c.event);
+        out.rootID.push_back(c.rootID);
+        out.nhits.push_back(int(c.n));
+        out.label.push_back(bestPDG);
+        out.etotal.push_back(etot);
+        out.length.push_back(length);
+        out.contained.push_back(c.contained);
+        out.offset.push_back(out.x.size());
+    }
+
+    void Book() override {
+        fFile = TFile::Open(fFileName.c_str(), "RECREATE");
+        fTree = new TTree("elabHits","per-primary clusters from gas hits");
+
+        fTree->Branch("EventNumber",    &fEvent);
+        fTree->Branch("RootID",         &fRootID);
+        fTree->Branch("nhits",          &fNHits);
+        fTree->Branch("TotalEDep",      &fETotal);
+        fTree->Branch("TrackLength",    &fLength);
+        fTree->Branch("Primaries",      &fPrimaries);
+        fTree->Branch("FullyContained", &fContained);
+        fTree->Branch("ParticleLabel",  &fLabel);
+        fTree->Branch("x_hits",   &fX);
+        fTree->Branch("y_hits",   &fY);
+        fTree->Branch("z_hits",   &fZ);
+        fTree->Branch("t_hits",   &fT);
+        fTree->Branch("Edep_hits",&fEdep);
+        fTree->Branch("px_hits",  &fPx);
+        fTree->Branch("py_hits",  &fPy);
+        fTree->Branch("pz_hits",  &fPz);
+    }
+
+    void Write(StageChunk& base) override {
+        const double W_factor = 38e-6; // MeV per ion pair
+        auto& in = static_cast<Chunk&>(base);
+        for (size_t r = 0; r < in.event.size(); ++r) {
+            const size_t b = in.offset[r], e = in.offset[r+1];
+            fEvent     = in.event[r];
+            fRootID    = in.rootID[r];
+            fNHits     = in.nhits[r];
+            fETotal    = in.etotal[r];
+            fLength    = in.length[r];
+            fPrimaries = fETotal / W_factor;
+            fContained = in.contained[r];
+            fLabel     = PDGName(in.label[r]);
+            fX.assign(in.x.begin() + b, in.x.begin() + e);
+            fY.assign(in.y.begin() + b, in.y.begin() + e);
+            fZ.assign(in.z.begin() + b, in.z.begin() + e);
+            fT.assign(in.t.begin() + b, in.t.begin() + e);
+            fEdep.assign(in.edep.begin() + b, in.edep.begin() + e);
+            fPx.assign(in.px.begin() + b, in.px.begin() + e);
+            fPy.assign(in.py.begin() + b, in.py.begin() + e);
+            fPz.assign(in.pz.begin() + b, in.pz.begin() + e);
+            fTree->Fill();
+        }
+    }
+
+    void Close() override {
+        fFile->Write();
+        fFile->Close();
+        std::cout << "Wrote clusters to " << fFileName << "\n";
+    }
+
+  private:
+    std::string fFileName;
+    TFile*      fFile = nullptr;
+    TTree*      fTree = nullptr;
+
+    int    fEvent = -1, fRootID = -1, fNHits = 0;
+    double fETotal = 0.0, fLength = 0.0, fPrimaries = 0.0;
+    bool   fContained = true;
+    std::string fLabel;
+    std::vector<double> fX, fY, fZ, fT, fEdep, fPx, fPy, fPz;
+};
+
+} // namespace steps
+
+#endif // StepsAnalysis_h
@@ -0,0 +1,88 @@
+// Single-pass analysis of the simulation output: every entry of 'steps' is
+// read and grouped once, and the clusters go to all the requested stages
+//   --digi <basename>   digitizer input 'nTuple' (as ConvertForDigi_withSelection)
+//   --fill <0|1>        digi: 1 = only fully contained clusters (default 1)
+//   --reco <file>       reco clusters 'elabHits' (as RecoTrack_faster.C)
+//   --digitize <file>   sparse camera images 'event_info' (Digitizer.h)
+//   --params <file>     digitizer parameters (default: built-in, see digitizer.txt)
+//   --seed <n>          digitizer seed (overrides the parameter file)
+//   -j <n>              threads (default: all cores)
+//   --chunk <n>         entries per chunk (default 500)
+//
+// Build:
+//   g++ -O3 -march=native -o analyzeSteps analyzeSteps.cpp `root-config --cflags --libs` -pthread -lm
+//
+// Use:
+//   ./analyzeSteps 'tpc_hits_t*.root' --digi digi_input --reco elab_tpc_hits.root -j 8
+//   ./analyzeSteps 'tpc_hits_t*.root' --digitize images.root --params digitizer.txt
+
+#include "StepsAnalysis.h"
+#include "Digitizer.h"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <memory>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <input_file.root|'pattern'> [--digi basename] [--fill 0|1] [--reco file.root]"
+                  << " [--digitize file.root] [--params digitizer.txt] [--seed n]"
+                  << " [-j nThreads] [--chunk entries]\n";
+        return 1;
+    }
+
+    const std::string input = argv[1];
+    std::string digiName, recoName, imageName, paramsName, seedValue;
+    bool     check_points = true;
+    unsigned nThreads = std::thread::hardware_concurrency();
+    Long64_t chunkSize = 500;
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << a << "\n";
+            return 1;
+        }
+        const std::string v = argv[++i];
+        if      (a == "--digi")  digiName = v;
+        else if (a == "--fill")  check_points = (std::stoi(v) == 1);
+        else if (a == "--reco")  recoName = v;
+        else if (a == "--digitize") imageName = v;
+        else if (a == "--params")   paramsName = v;
+        else if (a == "--seed")     seedValue = v;
+        else if (a == "-j")      nThreads = std::stoul(v);
+        else if (a == "--chunk") chunkSize = std::stoll(v);
+        else {
+            std::cerr << "Unknown option " << a << "\n";
+            return 1;
+        }
+    }
+
+    // output stages, in the order they are written
+    std::vector<std::unique_ptr<steps::Stage>> owned;
+    if (!digiName.empty()) owned.push_back(std::make_unique<steps::DigiStage>(digiName, check_points));
+    if (!recoName.empty()) owned.push_back(std::make_unique<steps::RecoStage>(recoName));
+    if (!imageName.empty()) {
+        steps::DigitizerParams params;
+        if (!paramsName.empty() && !params.Load(paramsName)) return 1;
+        if (!seedValue.empty()) params.seed = std::stoull(seedValue);
+        owned.push_back(std::make_unique<steps::DigitizerStage>(imageName, params));
+    }
+    if (owned.empty()) {
+        std::cerr << "Nothing to do: give at least one of --digi, --reco, --digitize\n";
+        return 1;
+    }
+
+    std::vector<steps::Stage*> stages;
+    for (auto& s : owned) stages.push_back(s.get());
+
+    steps::RunInfo info;
+    if (!steps::RunStages(input, stages, nThreads, chunkSize, info)) return 1;
+
+    std::cout << "Read " << info.entries << " entries once for " << stages.size()
+              << " stage(s) in " << info.seconds << " s" << std::endl;
+    return 0;
+}
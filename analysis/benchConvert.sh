@@ -0,0 +1,51 @@
+#!/bin/bash
+# Throughput benchmark of the converter, and check that the output does
+# not depend on the number of threads (and, with REF set, that it matches
+# a reference converter, e.g. one built from an older version).
+#
+# Use:
+#   ./benchConvert.sh '<input.root|tpc_hits_t*.root>' [fill_option=1] [thread counts...]
+#   REF=./convert_serial ./benchConvert.sh output_t0.root 1 1 2 4 8
+#
+# Env: CONVERT (default ./convert), REF (optional reference binary).
+
+set -e
+INPUT="$1"
+FILL="${2:-1}"
+shift 2 || shift $#
+THREADS="${*:-1 2 4 $(nproc)}"
+CONVERT="${CONVERT:-./convert}"
+OUT=bench_convert
+mkdir -p "$OUT"
+
+if [ -z "$INPUT" ]; then
+  echo "Usage: $0 '<input.root|pattern>' [fill_option] [thread counts...]"
+  exit 1
+fi
+
+if [ -n "$REF" ]; then
+  start=$(date +%s.%N)
+  "$REF" "$INPUT" "$OUT/ref" "$FILL" > /dev/null
+  end=$(date +%s.%N)
+  echo "reference  seconds=$(echo "$end - $start" | bc)"
+fi
+
+for n in $THREADS; do
+  "$CONVERT" "$INPUT" "$OUT/mt_$n" "$FILL" "$n" | grep CONVERT_BENCH
+done
+
+# row-by-row comparison of all nTuple branches
+python3 - "$OUT" ${REF:+ref} $(for n in $THREADS; do echo mt_$n; done) <<'PY'
+import sys, uproot, numpy as np
+d, names = sys.argv[1], sys.argv[2:]
+def load(n):
+    return uproot.open(f"{d}/{n}.root")["nTuple"].arrays(library="np")
+base = load(names[0])
+for n in names[1:]:
+    other = load(n)
+    same = all(len(base[k]) == len(other[k]) and
+               all(np.array_equal(a, b) for a, b in zip(base[k], other[k]))
+               for k in base)
+    print(f"{n} vs {names[0]}: {'identical' if same else 'DIFFERENT'}")
+    if not same: sys.exit(1)
+PY
@@ -0,0 +1,104 @@
+"""Chart CPU per event against energy resolution for scanCuts.mac.
+
+Usage:
+    python plotCutScan.py scanCuts.log [--dir .] [--out cutScan.png]
+
+For every "CUTSCAN cut_um=<v>" marker in the log, the CPU time of the run
+that follows is taken from the Geant4 run summary ("User=...s"), and the
+per-event gas energy (sum of edep in the steps trees of the worker files
+scan_cut_<v>um_*.root)
+gives the resolution of the main peak (sigma/E from an iterated
++-2.5 sigma window around the median).
+"""
+import argparse
+import glob
+import os
+import re
+
+import numpy as np
+import uproot
+import matplotlib.pyplot as plt
+
+
+def parse_log(path):
+    marker = re.compile(r"CUTSCAN cut_um=(\S+)")
+    timer = re.compile(r"User=([0-9.eE+-]+)s")
+    nev = re.compile(r"Number of events processed\s*:\s*(\d+)")
+    points, current = [], None
+    with open(path) as f:
+        for line in f:
+            m = marker.search(line)
+            if m:
+                current = {"cut": m.group(1), "cpu": None, "nev": None}
+                points.append(current)
+                continue
+            if current is None:
+                continue
+            m = nev.search(line)
+            if m and current["nev"] is None:
+                current["nev"] = int(m.group(1))
+            m = timer.search(line)
+            if m and current["cpu"] is None:
+                current["cpu"] = float(m.group(1))
+    return points
+
+
+def peak_resolution(e):
+    e = e[e > 0]
+    if len(e) < 10:
+        return np.nan, np.nan
+    mu, sigma = np.median(e), np.std(e)
+    for _ in range(10):
+        sel = e[np.abs(e - mu) < 2.5 * sigma]
+        if len(sel) < 10:
+            break
+        mu, sigma = sel.mean(), sel.std()
+    return mu, sigma / mu
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("log")
+    ap.add_argument("--dir", default=".")
+    ap.add_argument("--out", default="cutScan.png")
+    args = ap.parse_args()
+
+    rows = []
+    for p in parse_log(args.log):
+        fnames = sorted(glob.glob(os.path.join(args.dir, f"scan_cut_{p['cut']}um_*.root")))
+        if not fnames or not p["cpu"] or not p["nev"]:
+            print(f"skip cut={p['cut']} um (missing output or timing)")
+            continue
+        e_evt = []
+        for fname in fnames:
+            with uproot.open(fname) as f:
+                edep = f["steps"]["edep"].array(library="np")
+            e_evt.extend(np.sum(v) for v in edep)
+        e_evt = np.array(e_evt) * 1000.0  # keV
+        mu, res = peak_resolution(e_evt)
+        cpu_ev = 1e3 * p["cpu"] / p["nev"]
+        rows.append((float(p["cut"]), cpu_ev, mu, res))
+        print(f"cut={p['cut']:>6} um  CPU/event={cpu_ev:8.3f} ms  "
+              f"peak={mu:7.3f} keV  sigma/E={100*res:6.2f} %")
+
+    if not rows:
+        return
+    rows.sort()
+    cut, cpu, _, res = map(np.array, zip(*rows))
+
+    fig, ax = plt.subplots(figsize=(7, 5))
+    ax.plot(cpu, 100 * res, "o-")
+    for c, x, y in zip(cut, cpu, 100 * res):
+        ax.annotate(f"{c:g} um", (x, y), textcoords="offset points", xytext=(5, 5))
+    ax.set_xscale("log")
+    ax.set_xlabel("CPU per event [ms]")
+    ax.set_ylabel("sigma/E of the gas energy peak [%]")
+    ax.set_title("Gas production cut scan")
+    ax.grid(True, which="both", alpha=0.3)
+    fig.tight_layout()
+    fig.savefig(args.out)
+    print(f"saved {args.out}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,205 @@
+// Split a tree into parts, or merge files, without the per-entry
+// Fill loop of a ROOT macro.
+//
+//   split:  ./splitMerge split <input.root> [--tree nTuple] [--parts 10 | --size MB]
+//                              [--prefix output_] [-j threads]
+//           writes <prefix>0.root ... <prefix>N-1.root
+//   merge:  ./splitMerge merge <output.root> <input1.root> [input2.root ...]
+//
+// Merging copies the compressed baskets as they are (TFileMerger fast
+// mode, like hadd), so it runs at disk speed.
+//
+// Splitting: ROOT can only copy baskets without unzipping for a whole tree,
+// so each part is copied entry by entry, but
+//   - the part boundaries are placed on cluster boundaries, so every part
+//     reads each of its baskets once and no basket is shared by two parts;
+//   - the parts are written in parallel, one thread (own input handle) per part;
+//   - only the compression settings of the input are used.
+//
+// Build:
+//   g++ -O2 -o splitMerge splitMerge.cpp `root-config --cflags --libs` -pthread
+
+#include <TFile.h>
+#include <TTree.h>
+#include <TROOT.h>
+#include <TString.h>
+#include <TFileMerger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void Usage(const char* exe) {
+    std::cerr << "Usage:\n"
+              << "  " << exe << " split <input.root> [--tree nTuple] [--parts N | --size MB]"
+              << " [--prefix output_] [-j threads]\n"
+              << "  " << exe << " merge <output.root> <input1.root> [input2.root ...]\n";
+}
+
+// first entry of every cluster, plus nEntries at the end
+std::vector<Long64_t> ClusterStarts(TTree* tree) {
+    std::vector<Long64_t> starts;
+    const Long64_t n = tree->GetEntries();
+    auto it = tree->GetClusterIterator(0);
+    for (Long64_t start = it(); start < n; start = it()) starts.push_back(start);
+    starts.push_back(n);
+    return starts;
+}
+
+// entries [first, last) of treeName in input -> output, with the input compression
+bool CopyRange(const std::string& input, const std::string& treeName, const std::string& output,
+               Long64_t first, Long64_t last) {
+    std::unique_ptr<TFile> in(TFile::Open(input.c_str(), "READ"));
+    if (!in || in->IsZombie()) return false;
+    TTree* tree = nullptr;
+    in->GetObject(treeName.c_str(), tree);
+    if (!tree) return false;
+
+    std::unique_ptr<TFile> out(TFile::Open(output.c_str(), "RECREATE", "", in->GetCompressionSettings()));
+    if (!out || out->IsZombie()) {
+        std::cerr << "Error: Could not create output file " << output << std::endl;
+        return false;
+    }
+    out->cd();
+    TTree* part = tree->CloneTree(0);
+    for (Long64_t j = first; j < last; ++j) {
+        tree->GetEntry(j);
+        part->Fill();
+    }
+    part->Write();
+    return true;
+}
+
+int Split(int argc, char** argv) {
+    if (argc < 3) { Usage(argv[0]); return 1; }
+    const std::string input = argv[2];
+    std::string treeName = "nTuple", prefix = "output_";
+    int nParts = 10;
+    double sizeMB = 0.;
+    unsigned nThreads = std::thread::hardware_concurrency();
+
+    for (int i = 3; i < argc; i += 2) {
+        const std::string a = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Error: " << a << " needs a value" << std::endl;
+            Usage(argv[0]);
+            return 1;
+        }
+        const std::string v = argv[i+1];
+        try {
+            if      (a == "--tree")   treeName = v;
+            else if (a == "--parts")  nParts = std::stoi(v);
+            else if (a == "--size")   sizeMB = std::stod(v);
+            else if (a == "--prefix") prefix = v;
+            else if (a == "-j")       nThreads = std::stoul(v);
+            else { Usage(argv[0]); return 1; }
+        } catch (const std::exception&) {
+            std::cerr << "Error: bad value '" << v << "' for " << a << std::endl;
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if (nParts < 1 || sizeMB < 0.) {
+        std::cerr << "Error: --parts must be >= 1 and --size >= 0" << std::endl;
+        return 1;
+    }
+
+    std::vector<Long64_t> clusters;
+    Long64_t nEntries = 0;
+    {
+        std::unique_ptr<TFile> in(TFile::Open(input.c_str(), "READ"));
+        if (!in || in->IsZombie()) {
+            std::cerr << "Error: Could not open input file " << input << std::endl;
+            return 1;
+        }
+        TTree* tree = nullptr;
+        in->GetObject(treeName.c_str(), tree);
+        if (!tree) {
+            std::cerr << "Error: Could not find tree " << treeName << " in file." << std::endl;
+            return 1;
+        }
+        nEntries = tree->GetEntries();
+        if (nEntries == 0) {
+            std::cerr << "Warning: tree is empty." << std::endl;
+            return 0;
+        }
+        if (sizeMB > 0.)
+            nParts = int(std::ceil(tree->GetZipBytes() / (sizeMB * 1024. * 1024.)));
+        clusters = ClusterStarts(tree);
+    }
+    nParts = std::max(nParts, 1);
+
+    // boundaries: the cluster start closest to i * nEntries / nParts
+    std::vector<Long64_t> bounds{0};
+    for (int i = 1; i < nParts; ++i) {
+        const double ideal = double(nEntries) * i / nParts;
+        auto it = std::lower_bound(clusters.begin(), clusters.end(), Long64_t(ideal));
+        Long64_t b = *it;
+        if (it != clusters.begin() && ideal - *(it-1) < b - ideal) b = *(it-1);
+        bounds.push_back(std::max(b, bounds.back()));
+    }
+    bounds.push_back(nEntries);
+
+    ROOT::EnableThreadSafety();
+    std::atomic<int> next{0}, failed{0};
+    auto worker = [&]() {
+        for (int i = next++; i < nParts; i = next++) {
+            const std::string out = prefix + std::to_string(i) + ".root";
+            if (!CopyRange(input, treeName, out, bounds[i], bounds[i+1])) ++failed;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < std::max(1u, std::min<unsigned>(nThreads, nParts)); ++t) pool.emplace_back(worker);
+    for (auto& th : pool) th.join();
+
+    if (failed > 0) {
+        std::cerr << "Error: " << failed << " part(s) could not be written" << std::endl;
+        return 1;
+    }
+    std::cout << "Split " << nEntries << " entries of " << treeName << " into " << nParts
+              << " files " << prefix << "*.root" << std::endl;
+    return 0;
+}
+
+int Merge(int argc, char** argv) {
+    if (argc < 4) { Usage(argv[0]); return 1; }
+
+    TFileMerger merger(kFALSE, kFALSE);
+    merger.SetFastMethod(kTRUE);          // copy baskets without unzipping
+    merger.SetPrintLevel(0);
+    if (!merger.OutputFile(argv[2], "RECREATE")) {
+        std::cerr << "Error: Could not create output file " << argv[2] << std::endl;
+        return 1;
+    }
+    for (int i = 3; i < argc; ++i) {
+        if (!merger.AddFile(argv[i])) {
+            std::cerr << "Error: Could not open input file " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if (!merger.Merge()) {
+        std::cerr << "Error: merge failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Merged " << (argc - 3) << " files into " << argv[2] << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) { Usage(argv[0]); return 1; }
+    const std::string mode = argv[1];
+    if (mode == "split") return Split(argc, argv);
+    if (mode == "merge") return Merge(argc, argv);
+    Usage(argv[0]);
+    return 1;
+}
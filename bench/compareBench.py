@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Compare benchmark results (runBench.py) with a stored baseline.
+
+    python3 compareBench.py baseline.json bench_results.json [--tolerance 0.10]
+                            [--rss-tolerance 0.15] [--bytes-tolerance 0.02]
+
+A case (scenario, threads) regresses when, relative to the baseline,
+  events_per_s     drops by more than --tolerance
+  init_s           grows by more than --tolerance (and by more than 0.2 s)
+  peak_rss_mb      grows by more than --rss-tolerance
+  bytes_per_event  changes by more than --bytes-tolerance (the seeds are
+                   fixed, so the output should not change at all)
+Exit status 1 if any case regresses. Timings are only comparable on the
+same machine: record the baseline there (cp bench_results.json bench/baseline.json).
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data.get("meta", {}), {(r["scenario"], r["threads"]): r for r in data["results"]}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("baseline")
+    ap.add_argument("current")
+    ap.add_argument("--tolerance", type=float, default=0.10)
+    ap.add_argument("--rss-tolerance", type=float, default=0.15)
+    ap.add_argument("--bytes-tolerance", type=float, default=0.02)
+    args = ap.parse_args()
+
+    try:
+        base_meta, base = load(args.baseline)
+    except FileNotFoundError:
+        print("compareBench: no baseline %s; store one with\n  cp %s %s"
+              % (args.baseline, args.current, args.baseline))
+        return 0
+    cur_meta, cur = load(args.current)
+
+    if base_meta.get("host") != cur_meta.get("host"):
+        print("compareBench: warning: baseline from %s, results from %s"
+              % (base_meta.get("host"), cur_meta.get("host")))
+    if base_meta.get("scale") != cur_meta.get("scale"):
+        print("compareBench: warning: different --scale (%s vs %s)"
+              % (base_meta.get("scale"), cur_meta.get("scale")))
+
+    def rel(new, old):
+        return (new - old) / old if old else 0.0
+
+    regressions = 0
+    print("%-9s %3s %12s %8s %8s %8s %8s  %s"
+          % ("scenario", "thr", "events/s", "d(ev/s)", "d(init)", "d(rss)", "d(bytes)", "status"))
+    for key in sorted(set(base) | set(cur)):
+        if key not in cur:
+            print("%-9s %3d %12s %44s" % (key[0], key[1], "-", "missing in results"))
+            regressions += 1
+            continue
+        if key not in base:
+            print("%-9s %3d %12.1f %44s" % (key[0], key[1], cur[key]["events_per_s"], "new (no baseline)"))
+            continue
+
+        b, c = base[key], cur[key]
+        d_eps   = rel(c["events_per_s"], b["events_per_s"])
+        d_init  = rel(c["init_s"], b["init_s"])
+        d_rss   = rel(c["peak_rss_mb"], b["peak_rss_mb"])
+        d_bytes = rel(c["bytes_per_event"], b["bytes_per_event"])
+
+        flags = []
+        if d_eps < -args.tolerance:
+            flags.append("events/s")
+        if d_init > args.tolerance and c["init_s"] - b["init_s"] > 0.2:
+            flags.append("init")
+        if d_rss > args.rss_tolerance:
+            flags.append("rss")
+        if abs(d_bytes) > args.bytes_tolerance:
+            flags.append("bytes")
+        regressions += bool(flags)
+
+        print("%-9s %3d %12.1f %+7.1f%% %+7.1f%% %+7.1f%% %+7.1f%%  %s"
+              % (key[0], key[1], c["events_per_s"], 100 * d_eps, 100 * d_init,
+                 100 * d_rss, 100 * d_bytes, "REGRESSION: " + ", ".join(flags) if flags else "ok"))
+
+    print("compareBench: %d regression(s) (baseline %s, results %s)"
+          % (regressions, base_meta.get("commit", "?"), cur_meta.get("commit", "?")))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
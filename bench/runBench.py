@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Run the benchmark scenarios of scenarios.txt and write the results as JSON.
+
+    python3 runBench.py --exe ./exampleB3a [--threads 1,2,4] [--scenarios fe55,cxb]
+                        [--scale 1.0] [--work bench_work] [--out bench_results.json]
+
+Every (scenario, thread count) runs in its own directory, <work>/<name>_t<N>,
+with the seeds fixed in the macro. Recorded per case:
+  init_s           start of the process -> end of /run/initialize
+  run_s            first /run/beamOn -> end of the last one
+  events_per_s     events / run_s
+  peak_rss_mb      maximum resident set size of the process
+  bytes_per_event  size of the ROOT files written / events
+  speedup, efficiency   events_per_s relative to the smallest thread count
+Compare two result files with compareBench.py.
+"""
+
+import argparse
+import datetime
+import json
+import os
+import platform
+import subprocess
+import sys
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def read_scenarios(path):
+    scenarios = []
+    with open(path) as f:
+        for line in f:
+            line = line.split("#", 1)[0].split()
+            if not line or line[0] == "name":
+                continue
+            name, macro, events, beamons = line[0], line[1], int(line[2]), int(line[3])
+            scenarios.append({"name": name, "macro": os.path.join(HERE, macro),
+                              "events": events, "beamOns": beamons})
+    return scenarios
+
+
+def git_commit():
+    try:
+        return subprocess.check_output(["git", "-C", HERE, "rev-parse", "--short", "HEAD"],
+                                       stderr=subprocess.DEVNULL, text=True).strip()
+    except (OSError, subprocess.CalledProcessError):
+        return ""
+
+
+def run_case(exe, scenario, threads, events, case_dir):
+    os.makedirs(case_dir, exist_ok=True)
+    for f in os.listdir(case_dir):
+        if f.endswith(".root") or f.endswith(".txt"):
+            os.remove(os.path.join(case_dir, f))
+
+    driver = os.path.join(case_dir, "bench.mac")
+    with open(driver, "w") as f:
+        f.write("/control/alias threads %d\n" % threads)
+        f.write("/control/alias events %d\n" % events)
+        f.write("/control/execute %s\n" % scenario["macro"])
+
+    marks = {}
+    start = time.monotonic()
+    with open(os.path.join(case_dir, "bench.log"), "w") as log:
+        proc = subprocess.Popen([exe, driver], cwd=case_dir, stdout=subprocess.PIPE,
+                                stderr=subprocess.STDOUT, text=True, bufsize=1)
+        for line in proc.stdout:
+            log.write(line)
+            for mark in ("BENCH_INIT_DONE", "BENCH_RUN_START", "BENCH_RUN_END"):
+                if mark in line and mark not in marks:
+                    marks[mark] = time.monotonic() - start
+        _, status, usage = os.wait4(proc.pid, 0)
+    proc.returncode = os.waitstatus_to_exitcode(status)
+
+    if proc.returncode != 0 or len(marks) < 3:
+        sys.stderr.write("bench: %s with %d threads failed (exit %d), see %s\n"
+                         % (scenario["name"], threads, proc.returncode,
+                            os.path.join(case_dir, "bench.log")))
+        return None
+
+    total = events * scenario["beamOns"]
+    run_s = marks["BENCH_RUN_END"] - marks["BENCH_RUN_START"]
+    nbytes = sum(os.path.getsize(os.path.join(case_dir, f))
+                 for f in os.listdir(case_dir) if f.endswith(".root"))
+    return {
+        "scenario": scenario["name"],
+        "threads": threads,
+        "events": total,
+        "init_s": round(marks["BENCH_INIT_DONE"], 3),
+        "run_s": round(run_s, 3),
+        "events_per_s": round(total / run_s, 2) if run_s > 0 else 0.0,
+        "peak_rss_mb": round(usage.ru_maxrss / 1024.0, 1),   # kB on Linux
+        "bytes_per_event": round(nbytes / total, 1) if total else 0.0,
+    }
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("--exe", required=True, help="exampleB3a executable")
+    ap.add_argument("--threads", default="1,2,4", help="comma-separated thread counts")
+    ap.add_argument("--scenarios", default="", help="comma-separated names (default: all)")
+    ap.add_argument("--table", default=os.path.join(HERE, "scenarios.txt"))
+    ap.add_argument("--scale", type=float, default=1.0, help="multiply the event counts")
+    ap.add_argument("--spectra", default=os.path.join(HERE, "..", "spectra"))
+    ap.add_argument("--work", default="bench_work")
+    ap.add_argument("--out", default="bench_results.json")
+    args = ap.parse_args()
+
+    exe = os.path.abspath(args.exe)
+    threads = sorted({int(t) for t in args.threads.split(",") if t})
+    scenarios = read_scenarios(args.table)
+    if args.scenarios:
+        wanted = args.scenarios.split(",")
+        scenarios = [s for s in scenarios if s["name"] in wanted]
+
+    # the macros read ../spectra/..., relative to the case directory
+    work = os.path.abspath(args.work)
+    os.makedirs(work, exist_ok=True)
+    link = os.path.join(work, "spectra")
+    if not os.path.exists(link):
+        os.symlink(os.path.abspath(args.spectra), link)
+
+    results = []
+    for scenario in scenarios:
+        events = max(1, int(round(scenario["events"] * args.scale)))
+        base = None
+        for n in threads:
+            print("bench: %-8s %2d thread(s), %d events ..." % (scenario["name"], n, events),
+                  end="", flush=True)
+            r = run_case(exe, scenario, n, events,
+                         os.path.join(work, "%s_t%d" % (scenario["name"], n)))
+            if r is None:
+                print(" FAILED")
+                continue
+            if base is None:
+                base = r
+            r["speedup"] = round(r["events_per_s"] / base["events_per_s"], 3) if base["events_per_s"] else 0.0
+            r["efficiency"] = round(r["speedup"] * base["threads"] / n, 3)
+            results.append(r)
+            print(" %.1f events/s, init %.2f s, %.0f MB" % (r["events_per_s"], r["init_s"], r["peak_rss_mb"]))
+
+    out = {
+        "meta": {
+            "date": datetime.datetime.now().isoformat(timespec="seconds"),
+            "host": platform.node(),
+            "cpus": os.cpu_count(),
+            "commit": git_commit(),
+            "scale": args.scale,
+        },
+        "results": results,
+    }
+    with open(args.out, "w") as f:
+        json.dump(out, f, indent=1)
+    print("bench: results in %s" % os.path.abspath(args.out))
+    return 0 if len(results) == len(scenarios) * len(threads) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
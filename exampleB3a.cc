@@ -10,12 +10,16 @@
 #include "G4UIExecutive.hh"
 #include "G4AnalysisManager.hh"
 #include "G4TScoreNtupleWriter.hh"
+#include "G4AdjointSimManager.hh"
 
 #include "Randomize.hh"
 
 #include "DetectorConstruction.hh"
 #include "PhysicsList.hh"
 #include "ActionInitialization.hh"
+#include "CampaignRunner.hh"
+#include "Checkpoint.hh"
+#include "AdjointFlux.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -26,6 +30,21 @@ int main(int argc,char** argv)
   G4UIExecutive* ui = nullptr;
   if ( argc == 1 ) { ui = new G4UIExecutive(argc, argv);}
 
+  // Companion mode: build the electron track library for /B3/fastsim/
+  //   exampleB3a --build-track-library <out.dat> [macro]
+  G4String trackLibraryFile;
+  if ( argc >= 3 && G4String(argv[1]) == "--build-track-library" ) {
+    trackLibraryFile = argv[2];
+  }
+
+  // Continue an interrupted job (/B3/output/checkpointEvery):
+  //   exampleB3a --resume <macro>
+  G4bool resume = ( argc >= 3 && G4String(argv[1]) == "--resume" );
+
+  // Reverse Monte Carlo of the background fluxes (/B3/adjoint/):
+  //   exampleB3a --adjoint <macro>
+  G4bool adjoint = ( argc >= 3 && G4String(argv[1]) == "--adjoint" );
+
   // Optionally: choose a different Random engine...
   // G4Random::setTheEngine(new CLHEP::MTwistEngine);
 
@@ -35,19 +54,27 @@ int main(int argc,char** argv)
 
   // Construct the default run manager
   //
-  auto runManager =
-    G4RunManagerFactory::CreateRunManager(G4RunManagerType::Default);
+  // (G4AdjointSimManager runs the adjoint events from one thread)
+  auto runManager = G4RunManagerFactory::CreateRunManager(
+    adjoint ? G4RunManagerType::SerialOnly : G4RunManagerType::Default);
 
   // Set mandatory initialization classes
   //
   runManager->SetUserInitialization(new B3::DetectorConstruction);
   //
-  runManager->SetUserInitialization(new B3::PhysicsList);
+  runManager->SetUserInitialization(new B3::PhysicsList(adjoint));
 
   // Set user action initialization
   //
+  if ( adjoint ) {
+    B3a::AdjointFlux::SetEnabled(true);
+    G4AdjointSimManager::GetInstance();   // its /adjoint/ commands
+  }
   runManager->SetUserInitialization(new B3a::ActionInitialization());
 
+  // Campaign mode (/B3/campaign/run <table>): many points in one process
+  auto campaign = new B3::CampaignRunner;
+
   // Initialize visualization
   //
   auto visManager = new G4VisExecutive;
@@ -72,7 +99,26 @@ int main(int argc,char** argv)
 
   // Process macro or start UI session
   //
-  if ( ! ui ) {
+  if ( ! ui && ! trackLibraryFile.empty() ) {
+    // track library build (full simulation of single electrons)
+    G4String command = "/control/execute ";
+    G4String fileName = (argc > 3) ? argv[3] : "trackLibrary.mac";
+    UImanager->ApplyCommand("/B3/fastsim/record " + trackLibraryFile);
+    UImanager->ApplyCommand(command+fileName);
+  }
+  else if ( ! ui && resume ) {
+    // the run manager exists: the events can be seeded one by one
+    // the output directories of the runs are read as each run starts
+    if ( ! B3a::Checkpoint::Resume() ) {
+      G4cout << "--resume: no checkpoint (tpc_hits_*.ckpt) in this directory;"
+             << " looking in the output directory of each run" << G4endl;
+    }
+    UImanager->ApplyCommand(G4String("/control/execute ") + argv[2]);
+  }
+  else if ( ! ui && adjoint ) {
+    UImanager->ApplyCommand(G4String("/control/execute ") + argv[2]);
+  }
+  else if ( ! ui ) {
     // batch mode
     G4String command = "/control/execute ";
     G4String fileName = argv[1];
@@ -91,6 +137,7 @@ int main(int argc,char** argv)
   // owned and deleted by the run manager, so they should not be deleted
   // in the main() program !
 
+  delete campaign;
   delete visManager;
   delete runManager;
 }
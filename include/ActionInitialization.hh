@@ -37,17 +37,32 @@
 namespace B3a
 {
 
+class DiagnosticsMessenger;
+class OutputMessenger;
+class HistogramMessenger;
+class ModulationMessenger;
+class ConvergenceMessenger;
+class AdjointMessenger;
+
 /// Action initialization class.
 
 class ActionInitialization : public G4VUserActionInitialization
 {
   public:
-    ActionInitialization() = default;
-    ~ActionInitialization() override = default;
+    ActionInitialization();
+    ~ActionInitialization() override;
 
     void BuildForMaster() const override;
     void Build() const override;
 
+  private:
+    DiagnosticsMessenger* fDiagnosticsMessenger = nullptr;
+    OutputMessenger*      fOutputMessenger      = nullptr;
+    HistogramMessenger*   fHistogramMessenger   = nullptr;
+    ModulationMessenger*  fModulationMessenger  = nullptr;
+    ConvergenceMessenger* fConvergenceMessenger = nullptr;
+    AdjointMessenger*     fAdjointMessenger     = nullptr;
+
 };
 
 }
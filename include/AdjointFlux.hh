@@ -0,0 +1,69 @@
+/// \file B3/B3a/include/AdjointFlux.hh
+/// \brief Definition of the B3a::AdjointFlux class
+
+#ifndef B3aAdjointFlux_h
+#define B3aAdjointFlux_h 1
+
+#include "globals.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <string>
+#include <vector>
+
+namespace B3a {
+
+/// Reverse (adjoint) Monte Carlo of the isotropic background fluxes
+/// (exampleB3a --adjoint, /B3/adjoint/).
+///
+/// Every event of an adjoint run (G4AdjointSimManager) starts on the
+/// surface of the gas volume: the forward particle goes in and gives the
+/// energy deposit of the event, the adjoint particle is tracked backward
+/// until it reaches the external sphere (the one of the forward sphere
+/// source). There it has a forward type, energy E and adjoint weight w,
+/// and the event counts in the spectrum of each flux component j of that
+/// type with
+///   w * Phi_j(E),  Phi_j from spectra/Background/<j>.csv
+///                  [particles cm^-2 s^-1 sr^-1 MeV^-1], log-log interpolated.
+/// Summed over the events and divided by their number this is the rate of
+/// energy deposits in the gas, in counts/s per bin, for the flux incident
+/// isotropically on the sphere. The spectra of all components and their
+/// total are printed and written to <dir>/adjoint_run<R>.txt.
+///
+/// G4AdjointSimManager drives the run from one thread: --adjoint uses
+/// the serial run manager.
+
+class AdjointFlux
+{
+  public:
+    // main(), before the actions are built
+    static void   SetEnabled(G4bool on) { fEnabled = on; }
+    static G4bool IsEnabled() { return fEnabled; }
+    static G4bool IsRunning();   // an adjoint run is being processed
+
+    // from the messenger
+    static G4bool AddComponent(const G4String& name, const G4String& file,
+                               const G4String& particle);
+    static void   SetEdepBins(G4int n, G4double emin, G4double emax)
+    { fNBins = n; fEdepMin = emin; fEdepMax = emax; }
+    static void   SetSphereRadius(G4double r) { fSphereRadius = r; }
+    static void   BeamOn(G4int events);
+
+    static void BeginOfRun();
+    static void EndOfRun(G4int runID, const std::string& dir);
+    static void EndOfEvent(G4double edep);
+
+    // log-log interpolation of a flux table, 0 outside
+    static G4double Interpolate(const std::vector<G4double>& energy,
+                                const std::vector<G4double>& flux, G4double e);
+
+  private:
+    static inline G4bool   fEnabled      = false;
+    static inline G4int    fNBins        = 200;
+    static inline G4double fEdepMin      = 0.;
+    static inline G4double fEdepMax      = 100.*keV;
+    static inline G4double fSphereRadius = 50.*cm;   // as PrimaryGeneratorAction
+};
+
+} // namespace B3a
+
+#endif // B3aAdjointFlux_h
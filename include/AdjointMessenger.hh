@@ -0,0 +1,38 @@
+/// \file B3/B3a/include/AdjointMessenger.hh
+/// \brief Definition of the B3a::AdjointMessenger class
+
+#ifndef B3aAdjointMessenger_h
+#define B3aAdjointMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAnInteger;
+
+namespace B3a {
+
+/// /B3/adjoint/: reverse Monte Carlo of the background fluxes (AdjointFlux)
+
+class AdjointMessenger : public G4UImessenger
+{
+  public:
+    AdjointMessenger();
+    ~AdjointMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    G4UIdirectory*             fDir             = nullptr;
+    G4UIcommand*               fFluxCmd         = nullptr;
+    G4UIcommand*               fEdepBinsCmd     = nullptr;
+    G4UIcmdWithADoubleAndUnit* fSphereRadiusCmd = nullptr;
+    G4UIcommand*               fModelRangeCmd   = nullptr;
+    G4UIcmdWithAnInteger*      fBeamOnCmd       = nullptr;
+};
+
+} // namespace B3a
+
+#endif // B3aAdjointMessenger_h
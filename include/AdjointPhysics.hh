@@ -0,0 +1,46 @@
+/// \file B3/B3a/include/AdjointPhysics.hh
+/// \brief Definition of the B3::AdjointPhysics class
+
+#ifndef B3AdjointPhysics_h
+#define B3AdjointPhysics_h 1
+
+#include "G4VPhysicsConstructor.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+namespace B3
+{
+
+/// Reverse (adjoint) electromagnetic physics for adj_gamma and adj_e-
+/// (exampleB3a --adjoint, see B3a::AdjointFlux).
+///
+/// Registered after the forward EM physics: the adjoint cross sections
+/// are built from its processes (compt, phot, eIoni, eBrem), so
+/// G4GammaGeneralProcess must be off. Adjoint electrons get the continuous
+/// gain of energy of eIoni, adjoint multiple scattering and the inverse
+/// ionisation, bremsstrahlung, Compton and photoelectric reactions;
+/// adjoint gammas the inverse Compton and bremsstrahlung. The adjoint
+/// models cover [emin, emax] (/B3/adjoint/modelRange, before
+/// /run/initialize); the adjoint source is restricted to that range.
+
+class AdjointPhysics : public G4VPhysicsConstructor
+{
+  public:
+    AdjointPhysics();
+    ~AdjointPhysics() override = default;
+
+    void ConstructParticle() override;
+    void ConstructProcess() override;
+
+    static void     SetModelRange(G4double emin, G4double emax) { fEmin = emin; fEmax = emax; }
+    static G4double GetModelEmin() { return fEmin; }
+    static G4double GetModelEmax() { return fEmax; }
+
+  private:
+    static inline G4double fEmin = 1.*keV;
+    static inline G4double fEmax = 10.*MeV;
+};
+
+}
+
+#endif
@@ -0,0 +1,32 @@
+/// \file B3/B3a/include/CampaignMessenger.hh
+
+#ifndef B3CampaignMessenger_h
+#define B3CampaignMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+
+namespace B3 {
+
+class CampaignRunner;
+
+class CampaignMessenger : public G4UImessenger
+{
+  public:
+    CampaignMessenger(CampaignRunner* runner);
+    ~CampaignMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    CampaignRunner* fRunner = nullptr;
+    G4UIdirectory*  fDir    = nullptr;
+    G4UIcommand*    fRunCmd = nullptr;
+};
+
+} // namespace B3
+
+#endif // B3CampaignMessenger_h
@@ -0,0 +1,74 @@
+/// \file B3/B3a/include/CampaignRunner.hh
+/// \brief Definition of the B3::CampaignRunner class
+
+#ifndef B3CampaignRunner_h
+#define B3CampaignRunner_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <vector>
+
+namespace B3 {
+
+class CampaignMessenger;
+
+/// Runs a table of configurations back-to-back in one process
+/// (/B3/campaign/run <table>), after /run/initialize.
+///
+/// The first non-comment line names the columns, every other line is one
+/// point. Known columns are
+///   tag          output directory of the point (required)
+///   events       /run/beamOn (required)
+///   spectrum     /B3/primary/spectrumFile
+///   particle     /B3/primary/particle
+///   mode         /B3/primary/emissionMode
+///   sphereRadius /B3/primary/sphereRadius, cm
+///   pressure     /B3/det/pressure, atmosphere
+///   fractions    /B3/det/fractions, comma separated (He,CF4,Ar,SF6)
+///   radius       /B3/det/gasRadius, mm
+///   thickness    /B3/det/gasThickness, mm
+/// and a column named after a UI command (starting with '/') gets the
+/// value appended to it. "-" keeps the previous value.
+///
+/// Only the values that differ from the previous point are applied, so
+/// the spectrum is not reloaded and the geometry not rebuilt unless it
+/// changes. The output files of a point go to <tag>/; a timing table is
+/// printed at the end and written to the summary file.
+
+class CampaignRunner
+{
+  public:
+    CampaignRunner();
+    ~CampaignRunner();
+
+    void Run(const G4String& table, const G4String& summaryFile);
+
+  private:
+    struct Point {
+      G4String tag;
+      G4long   events = 0;
+      std::vector<std::pair<G4String, G4String>> settings;   // column -> value
+    };
+
+    struct Timing {
+      G4String tag;
+      G4long   events = 0;
+      G4double setup  = 0.;   // s, commands (spectrum loading, ...)
+      G4double wall   = 0.;   // s, beamOn (includes geometry/physics updates)
+      G4double user   = 0.;
+      G4bool   ok     = false;
+    };
+
+    G4bool ReadTable(const G4String& table, std::vector<Point>& points) const;
+    G4String CommandFor(const G4String& column, const G4String& value) const;
+    void PrintSummary(const std::vector<Timing>& timings, const G4String& summaryFile) const;
+
+    std::map<G4String, G4String> fApplied;   // column -> last applied value
+
+    CampaignMessenger* fMessenger = nullptr;
+};
+
+} // namespace B3
+
+#endif // B3CampaignRunner_h
@@ -0,0 +1,82 @@
+/// \file B3/B3a/include/Checkpoint.hh
+/// \brief Definition of the B3a::Checkpoint class
+
+#ifndef B3aCheckpoint_h
+#define B3aCheckpoint_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace B3a {
+
+/// Checkpoint / resume of long runs (/B3/output/checkpointEvery, --resume).
+///
+/// Every event is seeded by the master from its engine state at the start
+/// of the run (MT and tasking: one seed set per event; serial: SeedEvent
+/// reseeds the engine from the run seeds and the event ID), so the master
+/// state and the set of completed event IDs are enough to continue a run
+/// exactly:
+///   - the master saves its engine to checkpoint_run<R>.rndm at BeginOfRun;
+///   - each thread, every N events, AutoSaves its trees and then rewrites
+///     <output base>_run<R>.ckpt with the ranges of event IDs that are in
+///     its files on disk. ROOT's own periodic AutoSave is off meanwhile, so
+///     the files never hold entries beyond the last .ckpt.
+/// With --resume, the master restores the engine state of the run and the
+/// events listed in the .ckpt files are skipped; the new events go to files
+/// with an _r<attempt> suffix. The .ckpt files are read from the working
+/// directory and, at the start of each run, from the output directory of
+/// that run (RunAction::SetOutputDirectory, campaign points).
+
+class Checkpoint
+{
+  public:
+    using Ranges = std::vector<std::pair<G4int, G4int>>;  // [first, last]
+
+    static void   SetInterval(G4int events);
+    static G4int  GetInterval() { return fInterval; }
+    static G4bool IsEnabled() { return fInterval > 0 || fResume; }
+
+    // --resume: read the .ckpt files of dir; false if there are none
+    // there (output directories are read later, by StartRun)
+    static G4bool Resume(const std::string& dir = "");
+    static G4int  Attempt() { return fAttempt; }
+
+    // master, BeginOfRunAction: save (or, when resuming, restore) the engine
+    static void StartRun(G4int runID, const std::string& dir);
+
+    // serial run managers, before the primaries are generated: seed the
+    // event from (run seeds, event ID), as G4MTRunManager does
+    static void SeedEvent(G4int eventID);
+
+    // events written before the crash (read-only during the run)
+    static G4bool IsDone(G4int runID, G4int eventID);
+
+    // ranges helpers
+    static void AddEvent(Ranges& ranges, G4int eventID);
+    static void Append(Ranges& to, const Ranges& from);
+
+    // rewrite a thread checkpoint file (atomically)
+    static void Write(const std::string& file, G4int runID,
+                      const std::string& output, const Ranges& done);
+
+  private:
+    // read the .ckpt files of dir, once per directory
+    static G4bool Load(const std::string& dir);
+
+    static inline G4int  fInterval = 0;
+    static inline G4bool fResume   = false;
+    static inline G4int  fAttempt  = 0;
+    static inline std::map<G4int, Ranges> fDone;   // run -> completed events
+    static inline std::set<std::string>   fLoaded; // directories read
+    static inline G4bool fSerial = false;
+    static inline G4long fRunSeeds[2] = {0, 0};
+};
+
+} // namespace B3a
+
+#endif // B3aCheckpoint_h
@@ -0,0 +1,94 @@
+/// \file B3/B3a/include/Convergence.hh
+/// \brief Definition of the B3a::Convergence class
+
+#ifndef B3aConvergence_h
+#define B3aConvergence_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <string>
+#include <vector>
+
+class G4RunManager;
+
+namespace B3a {
+
+/// Stops a run once a statistical target is met (/B3/convergence/).
+///
+/// Targets:
+///   rate  relative error of the fraction of primaries with a gas deposit
+///   edep  relative error of the mean gas deposit per primary
+///   mu    error of the modulation factor in the ModulationCurve energy
+///         bin of a given photon energy (absolute, e.g. 0.01)
+///
+/// Every thread sums its events locally and adds them to the shared totals
+/// about every checkEvery / nThreads events; the thread that completes
+/// checkEvery events checks the precision of the totals and, when it is
+/// reached, aborts the run on the master (soft: events in flight finish).
+/// The /run/beamOn count is the budget. At the end of the run the events
+/// used and the precision reached are printed.
+///
+/// Importance biasing (/B3/phys/importanceBiasing): the edep target uses
+/// the weighted deposit (sum of track weight x edep), so it stays an
+/// unbiased mean per primary. The rate and mu targets count events and
+/// photoelectrons without weights; with weighted events in the run they
+/// are flagged as not valid in the end-of-run report.
+
+class Convergence
+{
+  public:
+    enum Target { kNone, kRate, kEdep, kMu };
+
+    // sums over events (per thread, and the shared totals)
+    struct Stats {
+      G4long   n = 0, nHit = 0;
+      G4long   nWeighted = 0;      // events with track weights != 1
+      G4double sumE = 0., sumE2 = 0.;
+      std::vector<G4long> phi;   // mu target: azimuth bins of the energy bin
+
+      void Reset(std::size_t nPhi)
+      { n = nHit = nWeighted = 0; sumE = sumE2 = 0.; phi.assign(nPhi, 0); }
+      void Add(const Stats& o) {
+        n += o.n; nHit += o.nHit; nWeighted += o.nWeighted; sumE += o.sumE; sumE2 += o.sumE2;
+        for (std::size_t i = 0; i < phi.size() && i < o.phi.size(); ++i) phi[i] += o.phi[i];
+      }
+    };
+
+    // master, from the messenger
+    static void SetTarget(Target t, G4double precision, G4double energy = 0.)
+    { fTarget = t; fPrecision = precision; fEnergy = energy; }
+    static void SetCheckEvery(G4int n) { fCheckEvery = n; }
+    static void SetMinEvents(G4long n) { fMinEvents = n; }
+    static G4bool IsEnabled() { return fTarget != kNone; }
+
+    // every thread
+    static void BeginOfRun();
+    static void EndOfRun();
+
+    // workers, end of event; the photoelectron (if any) before AddEvent.
+    // edep is the weighted deposit; weighted: some track weight was != 1
+    static void AddPhotoelectron(G4double energy, const G4ThreeVector& photonDir,
+                                 const G4ThreeVector& electronDir);
+    static void AddEvent(G4double edep, G4bool weighted = false);
+
+  private:
+    // precision of the totals for the target (< 0: not estimable yet)
+    static G4double Precision(const Stats& s, G4double& value);
+    static const char* Name(Target t);
+
+    static inline Target   fTarget     = kNone;
+    static inline G4double fPrecision  = 0.;
+    static inline G4double fEnergy     = 0.;
+    static inline G4int    fCheckEvery = 1000;
+    static inline G4long   fMinEvents  = 1000;
+
+    // with the shared totals (.cc), under their mutex
+    static inline G4long   fLastCheck = 0;
+    static inline G4bool   fReached   = false;
+    static inline G4RunManager* fMasterRunManager = nullptr;
+};
+
+} // namespace B3a
+
+#endif // B3aConvergence_h
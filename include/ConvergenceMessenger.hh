@@ -0,0 +1,35 @@
+/// \file B3/B3a/include/ConvergenceMessenger.hh
+/// \brief Definition of the B3a::ConvergenceMessenger class
+
+#ifndef B3aConvergenceMessenger_h
+#define B3aConvergenceMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithAnInteger;
+
+namespace B3a {
+
+/// /B3/convergence/: stop a run at a target precision (Convergence)
+
+class ConvergenceMessenger : public G4UImessenger
+{
+  public:
+    ConvergenceMessenger();
+    ~ConvergenceMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    G4UIdirectory*        fDir           = nullptr;
+    G4UIcommand*          fTargetCmd     = nullptr;
+    G4UIcmdWithAnInteger* fCheckEveryCmd = nullptr;
+    G4UIcmdWithAnInteger* fMinEventsCmd  = nullptr;
+};
+
+} // namespace B3a
+
+#endif // B3aConvergenceMessenger_h
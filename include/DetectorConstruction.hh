@@ -31,10 +31,13 @@
 #define B3DetectorConstruction_h 1
 
 #include "G4VUserDetectorConstruction.hh"
+#include "G4SystemOfUnits.hh"
 #include "globals.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
+class G4Material;
+class G4Tubs;
 
 namespace B3
 {
@@ -44,20 +47,64 @@ namespace B3
 /// Crystals are positioned in Ring, with an appropriate rotation matrix.
 /// Several copies of Ring are placed in the full detector.
 
+class ElectronTrackLibraryMessenger;
+class DetectorMessenger;
+class PixelReadoutMessenger;
+
 class DetectorConstruction : public G4VUserDetectorConstruction
 {
   public:
     DetectorConstruction();
-    ~DetectorConstruction() override = default;
+    ~DetectorConstruction() override;
 
   public:
     G4VPhysicalVolume* Construct() override;
     void ConstructSDandField() override;
 
+    // gas parameters (/B3/det/); after initialisation they take effect
+    // at the next run, rebuilding only the gas material or shape
+    void SetGasPressure(G4double p);
+    void SetGasFractions(G4double he, G4double cf4, G4double ar, G4double sf6);
+    void SetReferenceDensity(const G4String& gas, G4double rho);   // He, CF4, Ar, SF6
+    void SetGasRadius(G4double r);
+    void SetGasThickness(G4double dz);
+    void Print() const;
+
   private:
-    void DefineMaterials();
+    G4Material* BuildGasMaterial();
+    void UpdateGasShape();
+    void MaterialModified();
+    void ShapeModified();
 
     G4bool fCheckOverlaps = true;
+
+    // Fractions (sum to 1.0 in volume/partial pressure sense)
+    G4double fGasPressure = 1.*atmosphere;
+    G4double fHeFrac  = 0.6;
+    G4double fCF4Frac = 0.4;
+    G4double fArFrac  = 0.;
+    G4double fSF6Frac = 0.;
+
+    // Reference densities at 1 atm, 300 K for *pure* gas
+    G4double fRhoHeRef  = 162.488  * g/m3;
+    G4double fRhoCF4Ref = 3574.736 * g/m3;
+    G4double fRhoArRef  = 1394.0   * g/m3;
+    G4double fRhoSF6Ref = 6010.368 * g/m3;
+
+    G4double fGasRadius    = 36.9 * mm;
+    G4double fGasThickness = 50 * mm;
+
+    G4VPhysicalVolume* fWorldPV  = nullptr;
+    G4VPhysicalVolume* fGasPV    = nullptr;
+    G4LogicalVolume*   fGasLV    = nullptr;
+    G4Tubs*            fGasSolid = nullptr;
+    G4int              fGasVersion = 0;
+    G4bool             fMaterialModified = false;
+    G4bool             fShapeModified    = false;
+
+    ElectronTrackLibraryMessenger* fFastSimMessenger = nullptr;
+    DetectorMessenger*             fMessenger        = nullptr;
+    PixelReadoutMessenger*         fReadoutMessenger = nullptr;
 };
 
 }
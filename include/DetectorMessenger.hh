@@ -0,0 +1,39 @@
+/// \file B3/B3a/include/DetectorMessenger.hh
+
+#ifndef B3DetectorMessenger_h
+#define B3DetectorMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+namespace B3 {
+
+class DetectorConstruction;
+
+class DetectorMessenger : public G4UImessenger
+{
+  public:
+    DetectorMessenger(DetectorConstruction* detector);
+    ~DetectorMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    DetectorConstruction*      fDetector     = nullptr;
+    G4UIdirectory*             fDir          = nullptr;
+    G4UIcmdWithADoubleAndUnit* fPressureCmd  = nullptr;
+    G4UIcommand*               fFractionsCmd = nullptr;
+    G4UIcommand*               fRefDensCmd   = nullptr;
+    G4UIcmdWithADoubleAndUnit* fRadiusCmd    = nullptr;
+    G4UIcmdWithADoubleAndUnit* fThickCmd     = nullptr;
+    G4UIcmdWithoutParameter*   fPrintCmd     = nullptr;
+};
+
+} // namespace B3
+
+#endif // B3DetectorMessenger_h
@@ -0,0 +1,40 @@
+/// \file B3/B3a/include/DiagnosticsMessenger.hh
+
+#ifndef B3aDiagnosticsMessenger_h
+#define B3aDiagnosticsMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+
+namespace B3a {
+
+class DiagnosticsMessenger : public G4UImessenger
+{
+  public:
+    DiagnosticsMessenger();
+    ~DiagnosticsMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    G4UIdirectory*        fDir        = nullptr;
+    G4UIcmdWithABool*     fStepsCmd   = nullptr;
+    G4UIcmdWithABool*     fTimingCmd  = nullptr;
+    G4UIcmdWithAString*   fJsonCmd    = nullptr;
+    G4UIcmdWithABool*     fProfileCmd = nullptr;
+    G4UIcmdWithAnInteger* fTopCmd     = nullptr;
+    G4UIcmdWithABool*     fMemoryCmd  = nullptr;
+    G4UIcmdWithADoubleAndUnit* fProgressCmd = nullptr;
+    G4UIcmdWithAString*   fStatusCmd  = nullptr;
+};
+
+} // namespace B3a
+
+#endif // B3aDiagnosticsMessenger_h
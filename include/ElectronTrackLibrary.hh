@@ -0,0 +1,122 @@
+/// \file B3/B3a/include/ElectronTrackLibrary.hh
+/// \brief Definition of the B3::ElectronTrackLibrary class
+
+#ifndef B3ElectronTrackLibrary_h
+#define B3ElectronTrackLibrary_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <utility>
+#include <vector>
+
+namespace B3 {
+
+/// Library of fully simulated low-energy electron tracks in the gas,
+/// binned in log(energy). Used by ElectronTrackLibraryModel to replace
+/// the transport of keV electrons in TPCGasRegion.
+///
+/// Every track is stored in its own frame: vertex at the origin, initial
+/// direction along +z. Deposits of the whole subtree (delta rays,
+/// fluorescence, ...) are kept.
+///
+/// The library is built by the same executable:
+///   ./exampleB3a --build-track-library electronTracks.dat [trackLibrary.mac]
+/// and loaded with /B3/fastsim/library electronTracks.dat.
+///
+/// Track lengths scale with the gas density, so the file also records
+/// the density and elemental composition of TPCGasLV. A library made in
+/// another gas is not replayed: the fast simulation stays off (with a
+/// warning) until the gas matches again, checked at every run.
+///
+/// One instance per process; it is configured on the master and read
+/// by the workers.
+
+class ElectronTrackLibrary
+{
+  public:
+    struct Deposit {
+      G4float x, y, z;        // mm, track frame
+      G4float t;              // ns after the vertex
+      G4float px, py, pz;     // MeV/c, track frame
+      G4float edep;           // MeV
+      G4float stepLen;        // mm
+      G4int   pdg;
+      G4int   stepType, stepSubType;
+    };
+
+    struct Track {
+      G4double             energy = 0.;   // initial kinetic energy
+      std::vector<Deposit> deposits;
+    };
+
+    static ElectronTrackLibrary& Instance();
+
+    // ---- use (/B3/fastsim/) ----
+    void   SetEnabled(G4bool on) { fEnabled = on; }
+    G4bool IsActive() const { return fEnabled && fGasMatches && fNTracks > 0; }
+
+    // electrons below this are replaced; never above the library range
+    void     SetThreshold(G4double e) { fThreshold = e; }
+    G4double GetThreshold() const {
+      return (fThreshold > 0. && fThreshold < fEmax) ? fThreshold : fEmax;
+    }
+
+    G4bool Load(const G4String& filename);
+
+    // master, at the start of every run: is TPCGasLV the gas of the library?
+    G4bool CheckGas();
+
+    // random track of the bin containing energy (nullptr if the bin is empty)
+    const Track* Sample(G4double energy) const;
+
+    // ---- build (companion mode) ----
+    void SetRecordRange(G4double emin, G4double emax, G4int nBins);
+
+    void   StartRecording(const G4String& filename);
+    G4bool IsRecording() const { return fRecording; }
+
+    // round-robin over the bins so that each one gets the same statistics
+    G4double RecordEnergy(G4int eventID) const;
+
+    void AddTrack(Track&& track);   // thread safe
+    void Save() const;
+
+  private:
+    // gas of TPCGasLV: density and (Z, mass fraction) of its elements
+    struct Gas {
+      G4double density = 0.;
+      std::vector<std::pair<G4int, G4double>> fractions;
+    };
+
+    ElectronTrackLibrary() = default;
+
+    static G4bool CurrentGas(Gas& gas);   // false before the geometry is built
+
+    void  ResetBins();
+    G4int BinIndex(G4double energy) const;
+
+    G4bool   fEnabled = true;
+    G4bool   fRecording = false;
+    G4String fRecordFile;
+
+    // library range (from the file, or the one to record)
+    G4double fEmin  = 0.1  * keV;
+    G4double fEmax  = 30.0 * keV;
+    G4int    fNBins = 40;
+
+    G4double fThreshold = -1.;      // <= 0: whole library range
+
+    Gas    fGas;                     // of the loaded library
+    G4bool fGasMatches = true;
+
+    std::vector<std::vector<Track>> fBins;
+    std::size_t fNTracks = 0;
+
+    mutable G4Mutex fMutex;
+};
+
+} // namespace B3
+
+#endif // B3ElectronTrackLibrary_h
@@ -0,0 +1,36 @@
+/// \file B3/B3a/include/ElectronTrackLibraryMessenger.hh
+
+#ifndef B3ElectronTrackLibraryMessenger_h
+#define B3ElectronTrackLibraryMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+
+namespace B3 {
+
+class ElectronTrackLibraryMessenger : public G4UImessenger
+{
+  public:
+    ElectronTrackLibraryMessenger();
+    ~ElectronTrackLibraryMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    G4UIdirectory*             fDir          = nullptr;
+    G4UIcmdWithABool*          fEnableCmd    = nullptr;
+    G4UIcmdWithAString*        fLibraryCmd   = nullptr;
+    G4UIcmdWithADoubleAndUnit* fThresholdCmd = nullptr;
+    G4UIcmdWithAString*        fRecordCmd    = nullptr;
+    G4UIcommand*               fRangeCmd     = nullptr;
+};
+
+} // namespace B3
+
+#endif // B3ElectronTrackLibraryMessenger_h
@@ -0,0 +1,45 @@
+/// \file B3/B3a/include/ElectronTrackLibraryModel.hh
+/// \brief Definition of the B3::ElectronTrackLibraryModel class
+
+#ifndef B3ElectronTrackLibraryModel_h
+#define B3ElectronTrackLibraryModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+
+class G4Region;
+
+namespace B3 {
+
+class PixelReadoutScorer;
+class GasSD;
+
+/// Fast simulation of low-energy electrons in TPCGasRegion.
+///
+/// An electron below the ElectronTrackLibrary threshold is killed and
+/// replaced by a library track of the same energy bin, rotated onto its
+/// direction and translated to its position. The library deposits become
+/// GasHits of the killed track (and readout pixels), so the output format
+/// does not change.
+/// Deposits that land outside the gas are dropped, as the full
+/// simulation would have lost them too.
+
+class ElectronTrackLibraryModel : public G4VFastSimulationModel
+{
+  public:
+    // gasSD, pixels: detectors of the gas fed with the library deposits
+    ElectronTrackLibraryModel(const G4String& name, G4Region* region,
+                              GasSD* gasSD, PixelReadoutScorer* pixels = nullptr);
+    ~ElectronTrackLibraryModel() override = default;
+
+    G4bool IsApplicable(const G4ParticleDefinition&) override;
+    G4bool ModelTrigger(const G4FastTrack&) override;
+    void   DoIt(const G4FastTrack&, G4FastStep&) override;
+
+  private:
+    GasSD*              fGasSD  = nullptr;
+    PixelReadoutScorer* fPixels = nullptr;
+};
+
+} // namespace B3
+
+#endif // B3ElectronTrackLibraryModel_h
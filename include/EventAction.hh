@@ -2,7 +2,8 @@
 #pragma once
 #include "G4UserEventAction.hh"
 #include "globals.hh"
-#include <vector>
+#include "GasHit.hh"
+#include "G4ThreeVector.hh"
 #include <unordered_map>
 
 class G4Event;
@@ -13,33 +14,13 @@ class RunAction;
 
 class EventAction : public G4UserEventAction {
 public:
-  struct StepHit {
-    // existing fields
-    G4int    eventID, trackID, parentID, rootID, generation, pdg;
-    G4double x, y, z, t;     // mm, ns
-    G4double px, py, pz;     // MeV/c
-    G4double edep;           // MeV
-    G4double stepLen;        // mm
-    // process meta
-    G4int    creatorType;     // G4ProcessType enum value
-    G4int    creatorSubType;  // process-specific subtype
-    G4int    stepType;        // process that defined the step: type
-    G4int    stepSubType;     // process that defined the step: subtype
-
-    // -------------------------------------------------
-    // NEW: photoelectric-specific info (per step)
-    // -------------------------------------------------
-    G4int    isPE;            // 1 if this step was photoelectric, else 0
-    G4int    peTrackID;       // trackID of emitted e-
-    G4double pePx, pePy, pePz; // e- momentum (MeV/c)
-    G4double peEkin;          // e- kinetic energy (MeV)
-    G4double peTheta;         // polar angle of e- (rad)
-    G4double pePhi;           // azimuthal angle of e- (rad)
-    G4int    nPEsec;          // how many e- secondaries found
-  };
-
   G4double totalEdepGas() const { return fTotalEdepGas; }
-  void AddToTotalEdepGas(G4double dE) { fTotalEdepGas += dE; }
+  // weight: of the depositing track (importance biasing), 1 otherwise
+  void AddToTotalEdepGas(G4double dE, G4double weight = 1.) {
+    fTotalEdepGas += dE;
+    fWeightedEdepGas += weight * dE;
+    if (weight != 1.) fWeighted = true;
+  }
 
   explicit EventAction(RunAction* runAction);
   ~EventAction() override = default;
@@ -47,26 +28,55 @@ public:
   void BeginOfEventAction(const G4Event*) override;
   void EndOfEventAction  (const G4Event*) override;
 
-  std::vector<StepHit>&       steps()       { return fSteps; }
-  const std::vector<StepHit>& steps() const { return fSteps; }
+  // false with /B3/readout/writeSteps false: pixel lists only
+  G4bool KeepSteps() const { return fKeepSteps; }
 
   std::unordered_map<int,int>& primaryOfTrack()    { return fPrimaryOfTrack; }
   std::unordered_map<int,int>& generationOfTrack() { return fGenerationOfTrack; }
 
+  // rootID / generation of a track (GasSD and fast simulation)
+  void ResolveAncestry(G4int trackID, G4int parentID,
+                       G4int& rootID, G4int& generation);
+
+  // first photoabsorption of a primary photon in the gas (GasSD), for
+  // the modulation curve
+  void SetPhotoelectron(G4double photonE, const G4ThreeVector& photonDir,
+                        const G4ThreeVector& electronDir) {
+    if (fHasPE) return;
+    fHasPE = true;
+    fPhotonE = photonE; fPhotonDir = photonDir; fElectronDir = electronDir;
+  }
+
   void Clear() {
-    fSteps.clear();
     fPrimaryOfTrack.clear();
     fGenerationOfTrack.clear();
     fTotalEdepGas = 0.0;
+    fWeightedEdepGas = 0.0;
+    fWeighted = false;
+    fHasPE = false;
   }
 
 private:
+  // bytes held by the hits and the ancestry maps of the event; the maps
+  // are released when they grew above /B3/output/keepCapacity
+  G4double BufferBytes(const B3::GasHitsCollection* hits) const;
+  G4bool   ReleaseMaps();
+
   RunAction* fRunAction = nullptr;
 
-  std::vector<StepHit> fSteps;
   std::unordered_map<int,int> fPrimaryOfTrack;     // trackID -> root primary trackID
   std::unordered_map<int,int> fGenerationOfTrack;  // trackID -> 0,1,2,...
   G4double fTotalEdepGas = 0.0;
+  G4double fWeightedEdepGas = 0.0;   // sum of weight x edep [MeV]
+  G4bool   fWeighted     = false;    // some deposit had a weight != 1
+  G4bool   fKeepSteps    = true;
+  G4bool   fSkipped      = false;   // --resume: already written
+  G4int    fHitsHCID     = -1;
+  G4int    fPixelsHCID   = -1;
+
+  G4bool        fHasPE   = false;
+  G4double      fPhotonE = 0.;
+  G4ThreeVector fPhotonDir, fElectronDir;
 };
 
 } // namespace B3a
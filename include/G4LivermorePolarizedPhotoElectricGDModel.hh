@@ -4,6 +4,10 @@
 #include "G4VEmModel.hh"
 #include "G4ParticleChangeForGamma.hh"
 
+#include <vector>
+
+class G4LivermorePhotoElectricModel;
+
 class G4LivermorePolarizedPhotoElectricGDModel : public G4VEmModel {
 public:
   explicit G4LivermorePolarizedPhotoElectricGDModel(
@@ -11,16 +15,57 @@ public:
   ~G4LivermorePolarizedPhotoElectricGDModel() override = default;
 
   void Initialise(const G4ParticleDefinition*, const G4DataVector&) override;
+
+  // cross sections are the Livermore ones; only the final state differs
+  G4double ComputeCrossSectionPerAtom(const G4ParticleDefinition*,
+                                      G4double energy,
+                                      G4double Z, G4double A,
+                                      G4double cut, G4double emax) override;
+  G4double CrossSectionPerVolume(const G4Material*,
+                                 const G4ParticleDefinition*,
+                                 G4double energy,
+                                 G4double cut, G4double emax) override;
+
   void SampleSecondaries(std::vector<G4DynamicParticle*>*,
                          const G4MaterialCutsCouple*,
                          const G4DynamicParticle*,
                          G4double tCut,
                          G4double maxEnergy) override;
 
+  // Precompute the per-energy inverse CDFs of cos(theta).
+  // Called from Initialise(); public so that standalone tools can use it.
+  void BuildAngularTables();
+
+  // Sample the photoelectron direction in the photon frame
+  // (z along the photon, x along its polarization). Bounded cost:
+  // one table lookup for theta, closed form for phi.
+  void SampleAngles(G4double k,
+                    G4double& cosTheta, G4double& sinTheta,
+                    G4double& cosPhi,   G4double& sinPhi) const;
+
 private:
+  // GD angular density, split as f(c,phi) = g(c) * [A(c) cos^2 + B(c) sin^2]
+  static void PhiWeights(G4double k, G4double cosTheta,
+                         G4double& wCos2, G4double& wSin2);
+
   // in old code this was a value, but in your Geant4 we should really
   // grab it via GetParticleChangeForGamma() in Initialise()
   G4ParticleChangeForGamma* fParticleChange = nullptr;
+
+  // provides the Livermore cross sections in the regions we are attached to
+  // (registered with, and deleted by, G4LossTableManager like any G4VEmModel)
+  G4LivermorePhotoElectricModel* fXSModel = nullptr;
+
+  // inverse CDF tables: fCosTheta[iE*kNQuantiles + j] = cos(theta) at q_j,
+  // q_j = (1 - cos(pi j/(N-1)))/2
+  static constexpr G4int kNQuantiles  = 257;
+  static constexpr G4int kNIntegrate  = 2048;
+  static constexpr G4int kBinsPerDecade = 16;
+
+  std::vector<G4double> fCosTheta;
+  G4int    fNEnergies = 0;
+  G4double fLogEmin   = 0.;
+  G4double fInvDLogE  = 0.;
 };
 
 #endif
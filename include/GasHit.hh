@@ -0,0 +1,68 @@
+/// \file B3/B3a/include/GasHit.hh
+/// \brief Definition of the B3::GasHit class
+
+#ifndef B3GasHit_h
+#define B3GasHit_h 1
+
+#include "G4VHit.hh"
+#include "G4THitsCollection.hh"
+#include "G4Allocator.hh"
+#include "globals.hh"
+
+namespace B3 {
+
+/// One ionizing step in the gas (GasSD, or a track-library deposit of
+/// the fast simulation). Units as written to the "steps" tree.
+
+class GasHit : public G4VHit
+{
+  public:
+    GasHit() = default;
+    GasHit(const GasHit&) = default;
+    ~GasHit() override = default;
+
+    GasHit& operator=(const GasHit&) = default;
+
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
+    G4int    eventID = 0, trackID = 0, parentID = 0, rootID = 0, generation = 0, pdg = 0;
+    G4double x = 0., y = 0., z = 0., t = 0.;   // mm, ns
+    G4double px = 0., py = 0., pz = 0.;         // MeV/c
+    G4double edep = 0.;                         // MeV
+    G4double stepLen = 0.;                      // mm
+    G4double weight = 1.;                       // track weight (importance biasing)
+    // process meta
+    G4int    creatorType = -1;     // G4ProcessType enum value
+    G4int    creatorSubType = -1;  // process-specific subtype
+    G4int    stepType = -1;        // process that defined the step: type
+    G4int    stepSubType = -1;     // process that defined the step: subtype
+
+    // photoelectric-specific info (per step)
+    G4int    isPE = 0;             // 1 if this step was photoelectric, else 0
+    G4int    peTrackID = -1;       // trackID of emitted e-
+    G4double pePx = 0., pePy = 0., pePz = 0.;  // e- momentum (MeV/c)
+    G4double peEkin = 0.;          // e- kinetic energy (MeV)
+    G4double peTheta = 0.;         // polar angle of e- (rad)
+    G4double pePhi = 0.;           // azimuthal angle of e- (rad)
+    G4int    nPEsec = 0;           // how many e- secondaries found
+};
+
+using GasHitsCollection = G4THitsCollection<GasHit>;
+
+extern G4ThreadLocal G4Allocator<GasHit>* GasHitAllocator;
+
+inline void* GasHit::operator new(size_t)
+{
+  if (!GasHitAllocator) GasHitAllocator = new G4Allocator<GasHit>;
+  return (void*)GasHitAllocator->MallocSingle();
+}
+
+inline void GasHit::operator delete(void* hit)
+{
+  GasHitAllocator->FreeSingle((GasHit*)hit);
+}
+
+} // namespace B3
+
+#endif // B3GasHit_h
@@ -0,0 +1,52 @@
+/// \file B3/B3a/include/GasSD.hh
+/// \brief Definition of the B3::GasSD class
+
+#ifndef B3GasSD_h
+#define B3GasSD_h 1
+
+#include "G4VSensitiveDetector.hh"
+#include "GasHit.hh"
+
+class G4VProcess;
+
+namespace B3a { class EventAction; }
+
+namespace B3 {
+
+/// Sensitive detector of TPCGasLV: one GasHit per step with energy
+/// deposit, in the "GasHitsCollection" (written by RunAction as the
+/// "steps" tree). Only gas steps reach it; the photoelectron of a
+/// primary-gamma photoabsorption is recorded on the step that made it.
+///
+/// With /B3/readout/writeSteps false only the energy sum of the event
+/// is kept. The photoelectron is handed to the event (modulation curve)
+/// in both cases.
+
+class GasSD : public G4VSensitiveDetector
+{
+  public:
+    static constexpr const char* kHitsCollectionName = "GasHitsCollection";
+
+    explicit GasSD(const G4String& name);
+    ~GasSD() override = default;
+
+    void Initialize(G4HCofThisEvent*) override;
+    G4bool ProcessHits(G4Step*, G4TouchableHistory*) override;
+
+    // deposit that does not come from a G4Step (fast simulation)
+    void AddHit(const GasHit& hit);
+
+  private:
+    // electron made by the photoabsorption sp (else the most energetic
+    // one of the step); nEle = electrons of the step
+    static const G4Track* FindPhotoelectron(const G4Step* step, const G4VProcess* sp,
+                                            G4int& nEle);
+
+    GasHitsCollection* fHitsCollection = nullptr;
+    B3a::EventAction*  fEventAction    = nullptr;
+    G4int              fHCID           = -1;
+};
+
+} // namespace B3
+
+#endif // B3GasSD_h
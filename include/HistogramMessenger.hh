@@ -0,0 +1,37 @@
+/// \file B3/B3a/include/HistogramMessenger.hh
+/// \brief Definition of the B3a::HistogramMessenger class
+
+#ifndef B3aHistogramMessenger_h
+#define B3aHistogramMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+
+namespace B3a {
+
+/// /B3/histo/: online histograms (Histograms)
+
+class HistogramMessenger : public G4UImessenger
+{
+  public:
+    HistogramMessenger();
+    ~HistogramMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    G4UIdirectory*      fDir      = nullptr;
+    G4UIcommand*        fH1Cmd    = nullptr;
+    G4UIcommand*        fH2Cmd    = nullptr;
+    G4UIcmdWithABool*   fOnlyCmd  = nullptr;
+    G4UIcmdWithAString* fFileCmd  = nullptr;
+};
+
+} // namespace B3a
+
+#endif // B3aHistogramMessenger_h
@@ -0,0 +1,79 @@
+/// \file B3/B3a/include/Histograms.hh
+/// \brief Definition of the B3a::Histograms class
+
+#ifndef B3aHistograms_h
+#define B3aHistograms_h 1
+
+#include "globals.hh"
+#include "GasHit.hh"
+
+#include <string>
+#include <vector>
+
+class G4Event;
+
+namespace B3a {
+
+/// Online histograms (/B3/histo/), filled at the end of every event from
+/// the gas hits and merged over the threads by G4AnalysisManager.
+///
+/// Event quantities (fixed units):
+///   edep            total deposit in the gas [keV]
+///   edep:<particle> deposit by one species, e.g. edep:e-, edep:gamma [keV]
+///   primaryE        kinetic energy of the first primary [keV]
+///   radius, z       edep-weighted mean distance from the gas axis / z [mm]
+///   nHits           number of gas hits
+/// Under importance biasing every hit counts with its weight: edep is the
+/// weighted deposit, nHits the sum of the hit weights.
+/// Histograms of gas quantities only get events with a deposit; those of
+/// primaryE alone get every simulated event.
+///
+/// With /B3/histo/only the 'steps' and 'pixels' trees are not written.
+
+class Histograms
+{
+  public:
+    // master, from the messenger; false if a quantity is unknown
+    static G4bool AddH1(const G4String& q, G4int n, G4double min, G4double max);
+    static G4bool AddH2(const G4String& qx, G4int nx, G4double xmin, G4double xmax,
+                        const G4String& qy, G4int ny, G4double ymin, G4double ymax);
+
+    static void   SetOnly(G4bool on) { fOnly = on; }
+    static G4bool IsOnly() { return fOnly && HasAny(); }
+    static G4bool HasAny() { return !fDefs.empty(); }
+    static void   SetFileName(const G4String& name) { fFileName = name; }
+
+    // every thread
+    static void BeginOfRun(const std::string& dir);
+    static void EndOfRun();
+    static void Fill(const G4Event* event, const B3::GasHitsCollection* hits);
+
+  private:
+    enum Kind { kEdep, kPrimaryE, kRadius, kZ, kNHits };
+
+    struct Quantity {
+      Kind  kind = kEdep;
+      G4int pdg  = 0;          // edep:<particle>, 0 = all
+      G4String name;
+      G4bool NeedsGas() const { return kind != kPrimaryE; }
+    };
+
+    struct Definition {
+      Quantity x, y;
+      G4bool   is2D = false;
+      G4int    nx = 0, ny = 0;
+      G4double xmin = 0., xmax = 0., ymin = 0., ymax = 0.;
+    };
+
+    static G4bool ParseQuantity(const G4String& text, Quantity& q);
+    static G4double Value(const Quantity& q, const G4Event* event,
+                          const B3::GasHitsCollection* hits);
+
+    static inline std::vector<Definition> fDefs;
+    static inline G4bool   fOnly = false;
+    static inline G4String fFileName = "tpc_histos";
+};
+
+} // namespace B3a
+
+#endif // B3aHistograms_h
@@ -0,0 +1,88 @@
+/// \file B3/B3a/include/HitBuffer.hh
+/// \brief Definition of the B3a::HitBuffer class
+
+#ifndef B3aHitBuffer_h
+#define B3aHitBuffer_h 1
+
+#include "globals.hh"
+#include "GasHit.hh"
+
+#include <array>
+#include <vector>
+
+namespace B3a {
+
+/// Bounded per-event hit buffers and memory accounting.
+///
+/// Limit (/B3/output/maxHits, 0 = none): an event with more hits than
+/// that is written to the 'steps' tree
+///   spill    in several entries of at most maxHits hits (same eventID),
+///   coarsen  with consecutive steps of the same track merged (energy
+///            summed, position energy-weighted) until it fits; steps with
+///            a photoelectron are kept as they are. Whatever still does
+///            not fit is spilled.
+/// Buffers (/B3/output/keepCapacity): the output columns and the ancestry
+/// maps of EventAction keep their capacity between events up to this many
+/// hits (tracks); above it they are released after the event, so one
+/// outlier shower does not hold its memory for the rest of the run.
+///
+/// Accounting (always on, a few counters per event; report with
+/// /B3/diag/memory): hits per event (log2 histogram, peak and its event),
+/// buffer bytes of the event after its outputs were filled (peak per
+/// thread), events spilled or coarsened and buffers released.
+
+class HitBuffer
+{
+  public:
+    enum Policy { kSpill, kCoarsen };
+
+    static constexpr G4int kNBins = 28;   // 0, 1, 2-3, 4-7, ..., >= 2^26
+
+    struct Counters {
+      G4long   events = 0, hits = 0;
+      G4long   peakHits = 0;
+      G4int    peakEvent = -1;
+      G4double peakBytes = 0.;
+      G4long   spilled = 0, extraEntries = 0;
+      G4long   coarsened = 0, hitsIn = 0, hitsOut = 0;
+      G4long   released = 0;
+      std::array<G4long, kNBins> histogram{};
+    };
+
+    // master, from the messengers
+    static void   SetMaxHits(G4long n) { fMaxHits = n; }
+    static G4long GetMaxHits() { return fMaxHits; }
+    static void   SetPolicy(Policy p) { fPolicy = p; }
+    static Policy GetPolicy() { return fPolicy; }
+    static void   SetKeepCapacity(G4long n) { fKeepCapacity = n; }
+    static G4long GetKeepCapacity() { return fKeepCapacity; }
+    static void   SetReport(G4bool on) { fReport = on; }
+
+    // every thread
+    static void BeginOfRun();
+    static void EndOfRun(G4int runID);
+
+    // end of each written event: hits in the gas, bytes of the buffers
+    static void EndOfEvent(G4int eventID, G4long nHits, G4double bytes);
+    static void AddSpill(G4long extraEntries);
+    static void AddCoarsened(G4long hitsIn, G4long hitsOut);
+    static void AddRelease();
+
+    // hits merged by consecutive steps of a track, at most about maxHits
+    static void Coarsen(const std::vector<B3::GasHit*>& hits, G4long maxHits,
+                        std::vector<B3::GasHit>& out);
+
+    static G4int Bin(G4long nHits);
+
+  private:
+    static void Print(const Counters& c, G4int runID, std::size_t nThreads);
+
+    static inline G4long fMaxHits      = 0;
+    static inline Policy fPolicy       = kSpill;
+    static inline G4long fKeepCapacity = 100000;
+    static inline G4bool fReport       = false;
+};
+
+} // namespace B3a
+
+#endif // B3aHitBuffer_h
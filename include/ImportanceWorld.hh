@@ -0,0 +1,68 @@
+/// \file B3/B3a/include/ImportanceWorld.hh
+/// \brief Definition of the B3::ImportanceWorld class
+
+#ifndef B3ImportanceWorld_h
+#define B3ImportanceWorld_h 1
+
+#include "G4VUserParallelWorld.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4VPhysicalVolume;
+
+namespace B3 {
+
+class ImportanceWorldMessenger;
+
+/// Parallel world of concentric spheres around the TPC gas, used for
+/// geometry importance biasing of the hadronic backgrounds (protons,
+/// alphas, albedo neutrons) with G4ImportanceBiasing.
+///
+/// Shell k (0 = outermost) has importance ratio^(k+1), the world 1.
+/// A track crossing into a more important shell is split by the ratio,
+/// one moving out is Russian-rouletted with survival 1/ratio. Weights
+/// are carried by the tracks and written with the hits ("weight"); the
+/// pixel lists and the edep convergence target apply them too.
+///
+/// The shells are set with /B3/bias/; they follow the gas when it is
+/// resized (/B3/det/). The particles are chosen in the physics list
+/// (/B3/phys/importanceBiasing).
+
+class ImportanceWorld : public G4VUserParallelWorld
+{
+  public:
+    static constexpr const char* kWorldName = "ImportanceWorld";
+
+    ImportanceWorld();
+    ~ImportanceWorld() override;
+
+    void Construct() override;
+    void ConstructSD() override;
+
+    // n shells between rmin and rmax, radii in geometric progression;
+    // rmin <= 0: just outside the gas cylinder
+    void SetShells(G4int n, G4double rmin, G4double rmax);
+    void SetRatio(G4double ratio);
+    void Print() const;
+
+  private:
+    // shell radii (outermost first) and centre for the current gas;
+    // false (no shells) if there are none to build
+    G4bool Radii(std::vector<G4double>& radii, G4ThreeVector& centre) const;
+
+    G4int    fNShells = 6;
+    G4double fRmin    = -1.;
+    G4double fRmax    = 45.*cm;
+    G4double fRatio   = 2.;
+
+    std::vector<G4VPhysicalVolume*> fShells;   // outermost first
+
+    ImportanceWorldMessenger* fMessenger = nullptr;
+};
+
+} // namespace B3
+
+#endif // B3ImportanceWorld_h
@@ -0,0 +1,36 @@
+/// \file B3/B3a/include/ImportanceWorldMessenger.hh
+
+#ifndef B3ImportanceWorldMessenger_h
+#define B3ImportanceWorldMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithADouble;
+class G4UIcmdWithoutParameter;
+
+namespace B3 {
+
+class ImportanceWorld;
+
+class ImportanceWorldMessenger : public G4UImessenger
+{
+  public:
+    ImportanceWorldMessenger(ImportanceWorld* world);
+    ~ImportanceWorldMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    ImportanceWorld*         fWorld     = nullptr;
+    G4UIdirectory*           fDir       = nullptr;
+    G4UIcommand*             fShellsCmd = nullptr;
+    G4UIcmdWithADouble*      fRatioCmd  = nullptr;
+    G4UIcmdWithoutParameter* fPrintCmd  = nullptr;
+};
+
+} // namespace B3
+
+#endif // B3ImportanceWorldMessenger_h
@@ -0,0 +1,76 @@
+/// \file B3/B3a/include/ModulationCurve.hh
+/// \brief Definition of the B3a::ModulationCurve class
+
+#ifndef B3aModulationCurve_h
+#define B3aModulationCurve_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <string>
+#include <vector>
+
+namespace B3a {
+
+/// Modulation curve of the polarimetry runs (/B3/modulation/).
+///
+/// For every event in which a primary photon is photoabsorbed in the gas,
+/// the azimuth of the truth photoelectron (GasSD) is histogrammed in the
+/// bin of the photon energy. The azimuth is measured around the photon
+/// direction from the polarization axis of the generator (Y).
+///
+/// Each thread fills its own histograms; they are summed on the master at
+/// the end of the run, where every energy bin is fitted with
+///   N(phi) = A [1 + mu cos 2(phi - phi0)]
+/// and mu(E) is printed and written to <dir>/modulation_run<R>.txt.
+/// Nothing has to be written per step for this.
+///
+/// By default it is active only when the loaded spectrum is polarized.
+
+class ModulationCurve
+{
+  public:
+    enum Mode { kAuto, kOn, kOff };
+
+    struct Fit {
+      G4double mu = 0., muErr = 0., phi0 = 0., phi0Err = 0., chi2 = 0.;
+      G4int    ndf = 0;
+      G4bool   ok = false;
+    };
+
+    // master, from the messenger
+    static void SetMode(Mode m) { fMode = m; }
+    static void SetEnergyBins(G4int n, G4double emin, G4double emax)
+    { fNE = n; fEmin = emin; fEmax = emax; }
+    static void SetPhiBins(G4int n) { fNPhi = n; }
+
+    // every thread; on the workers 'polarized' is the state of the spectrum
+    static void   BeginOfRun(G4bool polarized);
+    static G4bool IsActive();
+    static void   EndOfRun(G4int runID, const std::string& dir);
+
+    // workers: one photoabsorption (photon energy and direction, electron direction)
+    static void Fill(G4double energy, const G4ThreeVector& photonDir,
+                     const G4ThreeVector& electronDir);
+
+    // helpers shared with Convergence
+    static G4int  EnergyBin(G4double energy);   // -1 outside the range
+    static G4int  PhiBin(const G4ThreeVector& photonDir, const G4ThreeVector& electronDir);
+    static G4int  GetPhiBins() { return fNPhi; }
+    static Fit    FitBin(const G4long* counts, G4int nPhi);
+
+  private:
+    static inline Mode     fMode = kAuto;
+    static inline G4int    fNE   = 10;
+    static inline G4double fEmin = 2. * keV;
+    static inline G4double fEmax = 22. * keV;
+    static inline G4int    fNPhi = 36;
+
+    // master: sum of the threads, [energy bin * nPhi + phi bin]
+    static inline std::vector<G4long> fMerged;
+};
+
+} // namespace B3a
+
+#endif // B3aModulationCurve_h
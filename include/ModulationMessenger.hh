@@ -0,0 +1,36 @@
+/// \file B3/B3a/include/ModulationMessenger.hh
+/// \brief Definition of the B3a::ModulationMessenger class
+
+#ifndef B3aModulationMessenger_h
+#define B3aModulationMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+
+namespace B3a {
+
+/// /B3/modulation/: modulation curve of polarimetry runs (ModulationCurve)
+
+class ModulationMessenger : public G4UImessenger
+{
+  public:
+    ModulationMessenger();
+    ~ModulationMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    G4UIdirectory*        fDir         = nullptr;
+    G4UIcmdWithAString*   fModeCmd     = nullptr;
+    G4UIcommand*          fEnergyCmd   = nullptr;
+    G4UIcmdWithAnInteger* fPhiBinsCmd  = nullptr;
+};
+
+} // namespace B3a
+
+#endif // B3aModulationMessenger_h
@@ -0,0 +1,43 @@
+/// \file B3/B3a/include/OutputMessenger.hh
+/// \brief Definition of the B3a::OutputMessenger class
+
+#ifndef B3aOutputMessenger_h
+#define B3aOutputMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+class G4UIcmdWithAString;
+
+namespace B3a {
+
+/// /B3/output/: how the per-thread ROOT files are written (RunAction)
+
+class OutputMessenger : public G4UImessenger
+{
+  public:
+    OutputMessenger();
+    ~OutputMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    G4UIdirectory*        fDir             = nullptr;
+    G4UIcmdWithAnInteger* fRotateEventsCmd = nullptr;
+    G4UIcmdWithADouble*   fRotateSizeCmd   = nullptr;
+    G4UIcmdWithAnInteger* fCheckpointCmd   = nullptr;
+    G4UIcmdWithAnInteger* fMaxHitsCmd      = nullptr;
+    G4UIcmdWithAString*   fOverflowCmd     = nullptr;
+    G4UIcmdWithAnInteger* fKeepCmd         = nullptr;
+
+    G4int    fRotateEvents = 0;
+    G4double fRotateMB     = 0.;
+};
+
+} // namespace B3a
+
+#endif // B3aOutputMessenger_h
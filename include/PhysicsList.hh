@@ -5,24 +5,77 @@
 #define B3PhysicsList_h 1
 
 #include "G4VModularPhysicsList.hh"
+#include "globals.hh"
+
+#include <map>
+#include <vector>
+
+class G4GeometrySampler;
 
 namespace B3
 {
 
+class PhysicsListMessenger;
+
 /// Modular physics list
 ///
 /// It includes the folowing physics builders
 /// - G4DecayPhysics
 /// - G4RadioactiveDecayPhysics
-/// - G4EmStandardPhysics
+/// - G4EmLivermorePolarizedPhysics
+/// - G4FastSimulationPhysics (e-)
+///
+/// - G4StepLimiterPhysics (G4UserLimits per region)
+///
+/// Optionally the photoelectric final state in TPCGasRegion is taken
+/// from G4LivermorePolarizedPhotoElectricGDModel (/B3/phys/gasPhotoElectric).
+///
+/// Geometry importance biasing (G4ImportanceBiasing on the shells of
+/// ImportanceWorld) can be switched on per particle with
+/// /B3/phys/importanceBiasing.
+///
+/// With adjoint = true (exampleB3a --adjoint) AdjointPhysics is added
+/// after the EM physics, for the reverse Monte Carlo of B3a::AdjointFlux.
+///
+/// Production cuts and tracking limits are kept per region and applied
+/// in SetCuts() (/B3/cuts/, /B3/limits/): 1 um in the world and in the
+/// gas by default.
 
 class PhysicsList: public G4VModularPhysicsList
 {
 public:
-  PhysicsList();
-  ~PhysicsList() override = default;
+  explicit PhysicsList(G4bool adjoint = false);
+  ~PhysicsList() override;
 
+  void ConstructProcess() override;
   void SetCuts() override;
+
+  // UI helpers
+  void SetGasPhotoElectricModel(const G4String& name);
+  void AddImportanceBiasing(const G4String& particle);
+
+  // region: "world", "gas" or any G4Region name; particle: "all" or a name
+  void SetRegionCut(const G4String& region, G4double cut, const G4String& particle);
+  void SetRegionMaxStep(const G4String& region, G4double maxStep);
+  void SetRegionMinEkin(const G4String& region, G4double minEkin);
+  void PrintRegionSettings() const;
+
+private:
+  struct RegionSettings {
+    std::map<G4String, G4double> cuts;   // particle -> range cut
+    G4double maxStep = -1.;              // <= 0: no limit
+    G4double minEkin = -1.;              // <= 0: no limit
+  };
+
+  static G4String RegionName(const G4String& alias);
+  void ApplyRegionSettings();
+
+  G4bool                fUseGDPhotoElectric = false;
+  PhysicsListMessenger* fMessenger          = nullptr;
+
+  std::vector<G4GeometrySampler*> fSamplers;   // one per biased particle
+
+  std::map<G4String, RegionSettings> fRegionSettings;
 };
 
 }
@@ -30,4 +83,3 @@ public:
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #endif
-
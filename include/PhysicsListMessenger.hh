@@ -0,0 +1,42 @@
+/// \file B3/B3a/include/PhysicsListMessenger.hh
+
+#ifndef B3PhysicsListMessenger_h
+#define B3PhysicsListMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+
+namespace B3 {
+
+class PhysicsList;
+
+class PhysicsListMessenger : public G4UImessenger
+{
+  public:
+    PhysicsListMessenger(PhysicsList* physics);
+    ~PhysicsListMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    PhysicsList*        fPhysics      = nullptr;
+    G4UIdirectory*      fDir          = nullptr;
+    G4UIcmdWithAString* fGasPECmd     = nullptr;
+    G4UIcmdWithAString* fBiasCmd      = nullptr;
+
+    G4UIdirectory*      fCutsDir      = nullptr;
+    G4UIcommand*        fCutCmd       = nullptr;
+    G4UIcommand*        fPrintCmd     = nullptr;
+
+    G4UIdirectory*      fLimitsDir    = nullptr;
+    G4UIcommand*        fMaxStepCmd   = nullptr;
+    G4UIcommand*        fMinEkinCmd   = nullptr;
+};
+
+} // namespace B3
+
+#endif // B3PhysicsListMessenger_h
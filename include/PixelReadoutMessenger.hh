@@ -0,0 +1,34 @@
+/// \file B3/B3a/include/PixelReadoutMessenger.hh
+
+#ifndef B3PixelReadoutMessenger_h
+#define B3PixelReadoutMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+
+namespace B3 {
+
+class PixelReadoutMessenger : public G4UImessenger
+{
+  public:
+    PixelReadoutMessenger();
+    ~PixelReadoutMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    G4UIdirectory*        fDir        = nullptr;
+    G4UIcmdWithABool*     fEnableCmd  = nullptr;
+    G4UIcommand*          fGridCmd    = nullptr;
+    G4UIcmdWithAnInteger* fSlicesCmd  = nullptr;
+    G4UIcmdWithABool*     fStepsCmd   = nullptr;
+};
+
+} // namespace B3
+
+#endif // B3PixelReadoutMessenger_h
@@ -0,0 +1,63 @@
+/// \file B3/B3a/include/PixelReadoutScorer.hh
+/// \brief Definition of the B3::PixelReadoutScorer class
+
+#ifndef B3PixelReadoutScorer_h
+#define B3PixelReadoutScorer_h 1
+
+#include "G4VPrimitiveScorer.hh"
+#include "G4THitsMap.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+
+class G4VSolid;
+
+namespace B3 {
+
+/// Readout-plane scorer of the gas: the energy of every step is projected
+/// along z onto a pixel grid over the end cap (centred on the cylinder
+/// axis), optionally split in z slices, and summed per pixel per event.
+/// The event map is sparse: only hit pixels are stored. Each deposit is
+/// multiplied by the track weight (1 without importance biasing), so the
+/// pixel energies are expected values like weight x edep of the steps.
+///
+/// Pixel index = (iz*ny + iy)*nx + ix; ix, iy from the lower-left corner
+/// of the grid, iz from the lower face of the gas (z = 0 in the world).
+///
+/// Configured with /B3/readout/ on the master between runs; when it is
+/// disabled ProcessHits returns at once.
+
+class PixelReadoutScorer : public G4VPrimitiveScorer
+{
+  public:
+    struct Settings {
+      G4bool   enabled    = false;
+      G4int    nx         = 740;
+      G4int    ny         = 740;
+      G4double pitch      = 0.1*mm;
+      G4int    nz         = 1;
+      G4bool   writeSteps = true;   // keep the per-step tree as well
+    };
+    static Settings& GetSettings();
+
+    explicit PixelReadoutScorer(const G4String& name = "pixels");
+    ~PixelReadoutScorer() override = default;
+
+    void Initialize(G4HCofThisEvent*) override;
+    void clear() override;
+
+    // deposit at a point of the gas frame (fast simulation, ProcessHits)
+    void AddDeposit(const G4ThreeVector& local, const G4VSolid* gasSolid, G4double edep);
+
+    static void Decode(G4int index, G4int& ix, G4int& iy, G4int& iz);
+
+  protected:
+    G4bool ProcessHits(G4Step*, G4TouchableHistory*) override;
+
+  private:
+    G4THitsMap<G4double>* fEvtMap = nullptr;
+    G4int fHCID = -1;
+};
+
+} // namespace B3
+
+#endif // B3PixelReadoutScorer_h
@@ -37,6 +37,9 @@ class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 
     void SetSphereRadius(G4double r) { fSphereRadius = r; }
 
+    // some bin of the loaded spectrum has a polarization fraction > 0
+    G4bool IsPolarized() const { return fPolarized; }
+
   private:
     // emission configuration
     EmissionMode               fEmissionMode;
@@ -57,6 +60,7 @@ class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
     std::vector<SpectrumBin> fBins;
     std::vector<G4double>    fCdf;
     G4double                 fTotalW;
+    G4bool                   fPolarized = false;
 
     void         LoadSpectrum(const G4String& filename);
     G4double     SampleEnergyFromSpectrum(G4double& outPolMean,
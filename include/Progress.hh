@@ -0,0 +1,51 @@
+/// \file B3/B3a/include/Progress.hh
+/// \brief Definition of the B3a::Progress class
+
+#ifndef B3aProgress_h
+#define B3aProgress_h 1
+
+#include "globals.hh"
+
+#include <string>
+
+namespace B3a {
+
+/// Live progress of a run (/B3/diag/progress, /B3/diag/statusFile).
+///
+/// Workers add their events, hits and bytes written to shared atomic
+/// counters (relaxed, no lock). A monitor thread of the master wakes every
+/// interval of wall-clock time and prints events done, events/s since the
+/// last report and since the start of the run, hits/s, MB written and the
+/// ETA for the /run/beamOn count. With a status file it also rewrites that
+/// file (JSON, replaced atomically) for the batch system to poll; it ends
+/// with "state": "done" when the run is over. A stalled job shows as an
+/// events/s of 0 with a status file that is still being updated.
+
+class Progress
+{
+  public:
+    // master, from the messenger
+    static void     SetInterval(G4double seconds) { fInterval = seconds; }
+    static G4double GetInterval() { return fInterval; }
+    static void     SetStatusFile(const G4String& name) { fStatusFile = name; }
+    static G4bool   IsEnabled() { return fInterval > 0.; }
+
+    // master: starts / stops the monitor thread
+    static void BeginOfRun(G4int runID, G4long events);
+    static void EndOfRun();
+
+    // workers
+    static void AddEvent(G4long hits);
+    static void AddBytes(G4long bytes);
+
+  private:
+    static void Monitor();
+    static void Report(G4bool done);
+
+    static inline G4double    fInterval = 0.;   // s, 0 = off
+    static inline std::string fStatusFile;
+};
+
+} // namespace B3a
+
+#endif // B3aProgress_h
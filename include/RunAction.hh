@@ -2,8 +2,11 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <type_traits>
 #include "G4UserRunAction.hh"
 #include "EventAction.hh"  // we need the struct
+#include "G4THitsMap.hh"
+#include "G4Accumulable.hh"
 
 class TFile;
 class TTree;
@@ -21,7 +24,7 @@ struct StepFlatColumns {
   std::vector<int> nPEsec;
 
   // doubles
-  std::vector<double> x, y, z, t, px, py, pz, edep, stepLen;
+  std::vector<double> x, y, z, t, px, py, pz, edep, stepLen, weight;
 
   // NEW doubles for PE
   std::vector<double> pePx, pePy, pePz;
@@ -29,31 +32,116 @@ struct StepFlatColumns {
   std::vector<double> peTheta;
   std::vector<double> pePhi;
 
+  // f(vector) for every column
+  template <class F> void forEach(F f) {
+    f(eventID); f(trackID); f(parentID); f(rootID); f(generation); f(pdg);
+    f(creatorType); f(creatorSubType); f(stepType); f(stepSubType);
+    f(isPE); f(peTrackID); f(nPEsec);
+    f(x); f(y); f(z); f(t); f(px); f(py); f(pz); f(edep); f(stepLen); f(weight);
+    f(pePx); f(pePy); f(pePz);
+    f(peEkin); f(peTheta); f(pePhi);
+  }
+
+  void clear() { forEach([](auto& v) { v.clear(); }); }
+
+  // memory held (capacity), and giving it back (HitBuffer)
+  std::size_t capacity() const { return x.capacity(); }
+  std::size_t bytes() {
+    std::size_t n = 0;
+    forEach([&n](auto& v) { n += v.capacity() * sizeof(v[0]); });
+    return n;
+  }
+  void release() { forEach([](auto& v) { std::decay_t<decltype(v)>().swap(v); }); }
+};
+
+// sparse readout image of one event (/B3/readout/), names as in the
+// reconstruction output read by analysis/checkDigi.py
+struct PixelColumns {
+  int eventID = 0;
+  int nRedpix = 0;
+  std::vector<int>   redpix_ix, redpix_iy;
+  std::vector<int>   redpix_slice;     // z slice
+  std::vector<float> redpix_iz;        // energy in the pixel, keV
+
   void clear() {
-    eventID.clear(); trackID.clear(); parentID.clear(); rootID.clear(); generation.clear(); pdg.clear();
-    creatorType.clear(); creatorSubType.clear(); stepType.clear(); stepSubType.clear();
-    isPE.clear(); peTrackID.clear(); nPEsec.clear();
-    x.clear(); y.clear(); z.clear(); t.clear(); px.clear(); py.clear(); pz.clear(); edep.clear(); stepLen.clear();
-    pePx.clear(); pePy.clear(); pePz.clear();
-    peEkin.clear(); peTheta.clear(); pePhi.clear();
+    nRedpix = 0;
+    redpix_ix.clear(); redpix_iy.clear(); redpix_slice.clear(); redpix_iz.clear();
   }
 };
 
 
 class RunAction : public G4UserRunAction {
 public:
-  RunAction() = default;
+  RunAction();
   ~RunAction() override = default;
 
   void BeginOfRunAction(const G4Run*) override;
   void EndOfRunAction  (const G4Run*) override;
 
-  void FillFromSteps(const std::vector<EventAction::StepHit>& steps);
+  // the hits of an event as one 'steps' entry, or several above
+  // /B3/output/maxHits (HitBuffer)
+  void FillFromSteps(const B3::GasHitsCollection& hits);
+  void FillPixels(G4int eventID, const G4THitsMap<G4double>& pixels);
+
+  // after the outputs of an event are filled: rotates the file if needed
+  void EndOfEvent(G4int eventID);
+
+  // bytes held by the output buffers; releasing them when they grew
+  // above /B3/output/keepCapacity (true if they did)
+  G4double BufferBytes();
+  G4bool   ReleaseBuffers();
+
+  // step diagnostics (SteppingAction)
+  void CountStep(G4bool inGas) { fNSteps += 1; if (inGas) fNGasSteps += 1; }
+
+  // where the per-thread files go (set on the master between runs,
+  // e.g. one directory per campaign point); "" = working directory
+  static void SetOutputDirectory(const std::string& dir) { fOutputDir = dir; }
+  static const std::string& GetOutputDirectory() { return fOutputDir; }
+
+  // output rotation (/B3/output/): start a new numbered file after this
+  // many events or megabytes written (0 = no limit). Each thread writes
+  // tpc_hits_t<N>_<chunk>.root and lists its chunks in tpc_hits_t<N>_index.txt.
+  static void SetRotation(G4int events, G4double megabytes)
+  { fRotateEvents = events; fRotateMB = megabytes; }
+  static G4bool IsRotating() { return fRotateEvents > 0 || fRotateMB > 0.; }
 
 private:
+  std::string FileBase() const;
+  void OpenOutput();
+  void CloseOutput();
+
+  // checkpoint (/B3/output/checkpointEvery): flush the trees, then record
+  // the events they hold
+  void SaveCheckpoint();
+  void CommitEvents();
+
+  static inline std::string fOutputDir;
+  static inline G4int    fRotateEvents = 0;
+  static inline G4double fRotateMB     = 0.;
+
+  // current chunk (rotation)
+  G4int  fChunk = 0;
+  G4long fChunkEvents = 0;
+  G4int  fChunkFirstEvent = -1;
+  G4int  fChunkLastEvent  = -1;
+  std::string fChunkFile;
+  G4long fBytesReported = 0;   // of the chunk, to Progress
+
+  // events on disk / filled since the last checkpoint (Checkpoint.hh)
+  G4int fRunID = 0;
+  std::vector<std::pair<G4int, G4int>> fDone, fPending;
+  G4int fSinceCheckpoint = 0;
+
   TFile* fOut  = nullptr;
   TTree* fTree = nullptr;
+  TTree* fPixelTree = nullptr;
   StepFlatColumns cols_;
+  std::vector<B3::GasHit> coarse_;   // coarsened hits of an event (HitBuffer)
+  PixelColumns    pixels_;
+
+  G4Accumulable<G4long> fNSteps    = 0;
+  G4Accumulable<G4long> fNGasSteps = 0;
 };
 
 } // namespace B3a
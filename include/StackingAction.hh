@@ -2,16 +2,109 @@
 #define B3StackingAction_h 1
 
 #include "G4UserStackingAction.hh"
+#include "G4AffineTransform.hh"
 #include "globals.hh"
 
+#include <array>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+class G4Region;
+class G4VSolid;
+
 namespace B3 {
 
+class StackingMessenger;
+
+/// Classification policy for new tracks (/B3/stack/):
+/// - species on the kill list are dropped (all neutrinos by default)
+/// - secondaries below a minimum energy, per region of creation
+///   (and optionally per species), are dropped
+/// - anything appearing after a global time cut is dropped
+/// - species on the defer list go to the waiting stack
+///
+/// With /B3/stack/earlyAbort the event is tracked in two stages:
+/// primaries and their direct products first, everything else waits.
+/// If nothing has deposited in the gas by then, the waiting tracks that
+/// cannot reach it (straight line in the vacuum world, or too little
+/// energy) are dropped, and if none is left the event is aborted and not
+/// written out. The abort goes through G4RunManager::AbortEvent, which
+/// also sets G4Event::IsAborted: that flag is what EventAction checks
+/// (G4EventManager::AbortCurrentEvent alone does not set it).
+///
+/// What was killed is counted per thread; the master prints the summed
+/// counts at the end of each run (PrintKillSummary).
+
 class StackingAction : public G4UserStackingAction {
 public:
-  StackingAction() = default;
-  ~StackingAction() override = default;
+  StackingAction();
+  ~StackingAction() override;
 
   G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track*) override;
+  void NewStage() override;
+  void PrepareNewEvent() override;
+
+  // UI helpers
+  void Kill(const G4String& particle, G4bool on);
+  void Defer(const G4String& particle, G4bool on);
+  void SetMinEnergy(const G4String& region, G4double e, const G4String& particle);
+  void SetTimeCut(G4double t) { fTimeCut = t; }
+  void SetEarlyAbort(G4bool on) { fEarlyAbort = on; }
+  void SetReachMinEnergy(G4double e) { fReachMinEnergy = e; }
+  void SetReachKeepUnstable(G4bool on) { fReachKeepUnstable = on; }
+  void PrintPolicy() const;
+
+  // counters of all StackingAction instances (call from the master)
+  static void ResetCounters();
+  static void PrintKillSummary();
+
+private:
+  enum KillReason { kSpecies, kMinEnergy, kTimeCut, kUnreachable, kNReasons };
+
+  struct KillCount {
+    G4long   n      = 0;
+    G4double energy = 0.;   // kinetic energy not tracked
+  };
+
+  struct MinEnergyRule {
+    G4String region;         // "world", "gas" or a G4Region name
+    G4int    pdg     = 0;    // 0: any species
+    G4double minEkin = 0.;
+    const G4Region* resolved = nullptr;
+  };
+
+  G4ClassificationOfNewTrack Killed(const G4Track*, KillReason);
+  G4ClassificationOfNewTrack Reclassify(const G4Track*);
+  void ResolveRegions();
+  G4bool GasReached() const;
+  G4bool CanReachGas(const G4Track*) const;
+
+  std::set<G4int> fKillPDG;
+  std::set<G4int> fDeferPDG;
+  std::vector<MinEnergyRule> fMinEnergy;
+  G4double fTimeCut = -1.;   // <= 0: off
+  G4bool   fRegionsResolved = false;
+
+  // two-stage tracking / early abort
+  G4bool   fEarlyAbort        = false;
+  G4double fReachMinEnergy    = 0.;
+  G4bool   fReachKeepUnstable = true;
+  G4int    fStage             = 0;
+  G4bool   fReclassifying     = false;
+  G4bool   fGasHit            = false;
+  G4long   fNReachable        = 0;
+  std::vector<G4int> fPrimaryIDs;
+  const G4VSolid*    fGasSolid = nullptr;
+  G4AffineTransform  fToGas;
+
+  std::array<KillCount, kNReasons> fKilled{};
+  std::unordered_map<G4int, KillCount> fKilledByPDG;
+  G4long fDeferred     = 0;
+  G4long fSeen         = 0;
+  G4long fEarlyAborted = 0;
+
+  StackingMessenger* fMessenger = nullptr;
 };
 
 } // namespace B3
@@ -0,0 +1,45 @@
+/// \file B3/B3a/include/StackingMessenger.hh
+
+#ifndef B3StackingMessenger_h
+#define B3StackingMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+class G4UIcmdWithABool;
+
+namespace B3 {
+
+class StackingAction;
+
+class StackingMessenger : public G4UImessenger
+{
+  public:
+    StackingMessenger(StackingAction* stacking);
+    ~StackingMessenger() override;
+
+    void SetNewValue(G4UIcommand* cmd, G4String value) override;
+
+  private:
+    StackingAction*            fAction       = nullptr;
+    G4UIdirectory*             fDir          = nullptr;
+    G4UIcmdWithAString*        fKillCmd      = nullptr;
+    G4UIcmdWithAString*        fKeepCmd      = nullptr;
+    G4UIcmdWithAString*        fDeferCmd     = nullptr;
+    G4UIcmdWithAString*        fUndeferCmd   = nullptr;
+    G4UIcommand*               fMinECmd      = nullptr;
+    G4UIcmdWithADoubleAndUnit* fTimeCutCmd   = nullptr;
+    G4UIcmdWithoutParameter*   fPrintCmd     = nullptr;
+    G4UIcmdWithABool*          fEarlyAbortCmd    = nullptr;
+    G4UIcmdWithADoubleAndUnit* fReachMinECmd     = nullptr;
+    G4UIcmdWithABool*          fReachUnstableCmd = nullptr;
+};
+
+} // namespace B3
+
+#endif // B3StackingMessenger_h
@@ -0,0 +1,57 @@
+/// \file B3/B3a/include/StepProfiler.hh
+/// \brief Definition of the B3a::StepProfiler class
+
+#ifndef B3aStepProfiler_h
+#define B3aStepProfiler_h 1
+
+#include "globals.hh"
+
+class G4Step;
+class G4LogicalVolume;
+class G4VProcess;
+
+namespace B3a {
+
+/// Steps and time per (particle, defining process, logical volume)
+/// (/B3/diag/profile, before the first run).
+///
+/// Every thread counts in a fixed table (open addressing, kCapacity
+/// slots, no allocation while stepping); keys that do not fit go to one
+/// overflow row. The time of a step is the time since the previous step
+/// of the event. The tables are summed on the master at the end of the
+/// run and the top rows are printed, ranked by time.
+
+class StepProfiler
+{
+  public:
+    static constexpr G4int kCapacity = 4096;   // power of 2
+
+    // master, from the messenger
+    static void   SetEnabled(G4bool on) { fEnabled = on; }
+    static G4bool IsEnabled() { return fEnabled; }
+    static void   SetTop(G4int n) { fTop = n; }
+
+    // every thread
+    static void BeginOfRun();
+    static void EndOfRun();
+
+    static void BeginOfEvent();
+    static void Step(const G4Step* step);
+
+    struct Slot {
+      G4int                  pdg = 0;
+      G4int                  process = 0;    // type << 16 | subtype, -1 = none
+      const G4LogicalVolume* volume = nullptr;
+      const G4VProcess*      definer = nullptr;   // for the name (thread-local)
+      G4long                 steps = 0;          // 0 = free slot
+      G4double               seconds = 0.;
+    };
+
+  private:
+    static inline G4bool fEnabled = false;
+    static inline G4int  fTop = 25;
+};
+
+} // namespace B3a
+
+#endif // B3aStepProfiler_h
@@ -1,17 +1,32 @@
 #pragma once
 #include "G4UserSteppingAction.hh"
+#include "globals.hh"
+
+class G4Region;
 
 namespace B3a {
 
-class EventAction;
+class RunAction;
 
+/// Optional diagnostics (/B3/diag/steps, before the first run): counts
+/// the steps in the world and in the gas. It also gives Timing the
+/// transport time in and out of the gas (/B3/diag/timing) and feeds the
+/// StepProfiler (/B3/diag/profile). Hits are made
+/// by B3::GasSD, so without diagnostics no stepping action is registered
+/// at all.
 class SteppingAction : public G4UserSteppingAction {
 public:
-  explicit SteppingAction(EventAction* ea);
+  explicit SteppingAction(RunAction* ra);
   void UserSteppingAction(const G4Step* step) override;
 
+  static void   SetEnabled(G4bool on) { fgEnabled = on; }
+  static G4bool IsEnabled() { return fgEnabled; }
+
 private:
-  EventAction* fEventAction; // not owned
+  RunAction* fRunAction; // not owned
+  const G4Region* fGasRegion = nullptr;
+
+  static inline G4bool fgEnabled = false;
 };
 
 } // namespace B3a
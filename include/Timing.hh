@@ -0,0 +1,98 @@
+/// \file B3/B3a/include/Timing.hh
+/// \brief Definition of the B3a::Timing class
+
+#ifndef B3aTiming_h
+#define B3aTiming_h 1
+
+#include "globals.hh"
+
+#include <array>
+#include <chrono>
+#include <string>
+
+namespace B3a {
+
+/// Where the time goes (/B3/diag/timing), per thread and merged.
+///
+/// Only built with the B3_TIMING compile definition (cmake -DB3_TIMING=ON);
+/// otherwise the B3_TIME / B3_TIMING_CALL macros below expand to nothing
+/// and the stepping hook is not registered.
+///
+/// Stages (steady clock, thread-local sums):
+///   generatePrimaries   PrimaryGeneratorAction::GeneratePrimaries
+///   steppingGas/Other   transport time, i.e. the time between two calls
+///                       of the stepping action, by region of the step
+///   endOfEventAction    EventAction::EndOfEventAction (all outputs)
+///   fillFromSteps       RunAction::FillFromSteps (includes its treeFill)
+///   treeFill            TTree::Fill of 'steps' and 'pixels'
+///   fileClose           Write + Close of the output files
+/// The report at the end of the run also gives events/s, hits/event and
+/// bytes/event; with /B3/diag/timingJson it is also written as JSON.
+
+class Timing
+{
+  public:
+    enum Stage { kGenerate, kSteppingGas, kSteppingOther, kEndOfEvent,
+                 kFillFromSteps, kTreeFill, kFileClose, kNStages };
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Counters {
+      std::array<G4double, kNStages> seconds{};
+      std::array<G4long, kNStages>   calls{};
+      G4long   events = 0, hits = 0;
+      G4double bytes = 0.;
+      G4double wall = 0.;    // BeginOfRun -> EndOfRun of the thread
+    };
+
+    // master, from the messenger
+    static G4bool IsCompiled();
+    static void   SetEnabled(G4bool on) { fEnabled = on && IsCompiled(); }
+    static G4bool IsEnabled() { return fEnabled; }
+    static void   SetJsonFile(const G4String& name) { fJsonFile = name; }
+
+    // every thread
+    static void BeginOfRun();
+    static void EndOfRun(G4int runID);
+
+    static void Add(Stage s, G4double seconds);
+    static void BeginOfEvent();
+    static void EndOfEvent();
+    static void Step(G4bool inGas);
+    static void AddHits(G4long n);
+    static void AddBytes(G4double n);
+
+    // times the enclosing scope
+    class Scope
+    {
+      public:
+        explicit Scope(Stage s) : fStage(s), fOn(fEnabled)
+        { if (fOn) fStart = Clock::now(); }
+        ~Scope()
+        { if (fOn) Add(fStage, std::chrono::duration<G4double>(Clock::now() - fStart).count()); }
+      private:
+        Stage fStage;
+        G4bool fOn;
+        Clock::time_point fStart;
+    };
+
+  private:
+    static const char* Name(Stage s);
+    static void Print(const char* label, const Counters& c);
+    static std::string Json(const Counters& c);
+
+    static inline G4bool   fEnabled = false;
+    static inline G4String fJsonFile;
+};
+
+} // namespace B3a
+
+#ifdef B3_TIMING
+#define B3_TIME(stage)       B3a::Timing::Scope b3Time_##stage(B3a::Timing::stage)
+#define B3_TIMING_CALL(call) call
+#else
+#define B3_TIME(stage)       ((void)0)
+#define B3_TIMING_CALL(call) ((void)0)
+#endif
+
+#endif // B3aTiming_h
@@ -33,6 +33,17 @@
 #include "PrimaryGeneratorAction.hh"
 #include "StackingAction.hh"
 #include "SteppingAction.hh"
+#include "DiagnosticsMessenger.hh"
+#include "OutputMessenger.hh"
+#include "HistogramMessenger.hh"
+#include "ModulationMessenger.hh"
+#include "ConvergenceMessenger.hh"
+#include "AdjointMessenger.hh"
+#include "AdjointFlux.hh"
+#include "Timing.hh"
+#include "StepProfiler.hh"
+
+#include "G4AdjointSimManager.hh"
 
 using namespace B3;
 
@@ -41,6 +52,26 @@ namespace B3a
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+ActionInitialization::ActionInitialization()
+{
+  fDiagnosticsMessenger = new DiagnosticsMessenger();
+  fOutputMessenger      = new OutputMessenger();
+  fHistogramMessenger   = new HistogramMessenger();
+  fModulationMessenger  = new ModulationMessenger();
+  fConvergenceMessenger = new ConvergenceMessenger();
+  fAdjointMessenger     = new AdjointMessenger();
+}
+
+ActionInitialization::~ActionInitialization()
+{
+  delete fDiagnosticsMessenger;
+  delete fOutputMessenger;
+  delete fHistogramMessenger;
+  delete fModulationMessenger;
+  delete fConvergenceMessenger;
+  delete fAdjointMessenger;
+}
+
 void ActionInitialization::BuildForMaster() const
 {
   SetUserAction(new RunAction);
@@ -59,7 +90,16 @@ void ActionInitialization::Build() const {
   SetUserAction(new PrimaryGeneratorAction);
   SetUserAction(new StackingAction);
 
-  SetUserAction(new SteppingAction(eventAction)); // NEW
+  // hits come from B3::GasSD; the stepping action is diagnostics only
+  if (SteppingAction::IsEnabled() || Timing::IsEnabled() || StepProfiler::IsEnabled()) {
+    SetUserAction(new SteppingAction(runAction));
+  }
+
+  // adjoint runs (--adjoint) call the same run and event actions
+  if (AdjointFlux::IsEnabled()) {
+    G4AdjointSimManager::GetInstance()->SetAdjointRunAction(runAction);
+    G4AdjointSimManager::GetInstance()->SetAdjointEventAction(eventAction);
+  }
 }
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
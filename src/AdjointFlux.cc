@@ -0,0 +1,249 @@
+/// \file B3/B3a/src/AdjointFlux.cc
+/// \brief Implementation of the B3a::AdjointFlux class
+
+#include "AdjointFlux.hh"
+#include "AdjointPhysics.hh"
+
+#include "G4AdjointSimManager.hh"
+#include "G4ParticleTable.hh"
+#include "G4ThreeVector.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace B3a {
+
+namespace {
+// rate per edep bin: sum of the event weights and of their squares
+struct Spectrum {
+  std::vector<G4double> sum, sum2;
+  G4double any = 0., any2 = 0.;   // events with a deposit, all edep
+
+  void Reset(G4int nBins) { sum.assign(nBins, 0.); sum2.assign(nBins, 0.); any = any2 = 0.; }
+  void Add(G4int bin, G4double w) {
+    any += w; any2 += w * w;
+    if (bin >= 0) { sum[bin] += w; sum2[bin] += w * w; }
+  }
+};
+
+struct Component {
+  std::string name, particle;
+  G4int pdg = 0;
+  std::vector<G4double> energy, flux;   // internal units; flux per sr and s
+  G4double event = 0.;                  // weight of the current event
+  Spectrum spectrum;
+};
+
+// adjoint runs are serial (--adjoint): no per-thread copies
+std::vector<Component> gComponents;
+Spectrum gTotal;
+G4long gEvents = 0;    // adjoint events of the run
+G4long gReached = 0;   // ... with an adjoint track on the sphere and a deposit
+G4bool gRunning = false;
+}
+
+G4bool AdjointFlux::IsRunning()
+{
+  return fEnabled && gRunning;
+}
+
+G4double AdjointFlux::Interpolate(const std::vector<G4double>& energy,
+                                  const std::vector<G4double>& flux, G4double e)
+{
+  if (energy.size() < 2 || e < energy.front() || e > energy.back()) return 0.;
+
+  const auto it = std::upper_bound(energy.begin(), energy.end(), e);
+  const std::size_t i = std::min<std::size_t>(it - energy.begin(), energy.size() - 1);
+  const G4double e0 = energy[i - 1], e1 = energy[i];
+  const G4double f0 = flux[i - 1],   f1 = flux[i];
+  if (f0 <= 0. || f1 <= 0.) return f0 + (f1 - f0) * (e - e0) / (e1 - e0);
+  return f0 * std::pow(f1 / f0, std::log(e / e0) / std::log(e1 / e0));
+}
+
+G4bool AdjointFlux::AddComponent(const G4String& name, const G4String& file,
+                                 const G4String& particle)
+{
+  if (particle != "gamma" && particle != "e-") {
+    G4cerr << "/B3/adjoint/flux: " << particle << ": the adjoint physics has gamma and e- only"
+           << G4endl;
+    return false;
+  }
+
+  std::ifstream in(file);
+  if (!in) {
+    G4cerr << "/B3/adjoint/flux: cannot open " << file << G4endl;
+    return false;
+  }
+
+  // E[MeV], Phi(E) [cm^-2 s^-1 sr^-1 MeV^-1], as read by LoadSpectrum
+  Component c;
+  c.name = name;
+  c.particle = particle;
+  c.pdg = G4ParticleTable::GetParticleTable()->FindParticle(particle)->GetPDGEncoding();
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream is(line);
+    G4double e, phi;
+    if (!(is >> e >> phi)) continue;
+    if (!c.energy.empty() && e*MeV <= c.energy.back()) {
+      G4cerr << "/B3/adjoint/flux: " << file << ": energies must increase" << G4endl;
+      return false;
+    }
+    c.energy.push_back(e*MeV);
+    c.flux.push_back(phi / (cm2*MeV));
+  }
+  if (c.energy.size() < 2) {
+    G4cerr << "/B3/adjoint/flux: " << file << ": fewer than 2 points" << G4endl;
+    return false;
+  }
+
+  auto it = std::find_if(gComponents.begin(), gComponents.end(),
+                         [&name](const Component& o) { return o.name == name; });
+  if (it != gComponents.end()) *it = std::move(c);
+  else gComponents.push_back(std::move(c));
+  return true;
+}
+
+void AdjointFlux::BeamOn(G4int events)
+{
+  if (!fEnabled) {
+    G4cerr << "/B3/adjoint/beamOn: start the job with exampleB3a --adjoint <macro>" << G4endl;
+    return;
+  }
+  if (gComponents.empty()) {
+    G4cerr << "/B3/adjoint/beamOn: no flux (/B3/adjoint/flux)" << G4endl;
+    return;
+  }
+
+  // adjoint source energies: where the fluxes and the adjoint models overlap
+  G4double emin = DBL_MAX, emax = 0.;
+  for (const auto& c : gComponents) {
+    emin = std::min(emin, c.energy.front());
+    emax = std::max(emax, c.energy.back());
+  }
+  const G4double modelEmin = B3::AdjointPhysics::GetModelEmin();
+  const G4double modelEmax = B3::AdjointPhysics::GetModelEmax();
+  if (emin < modelEmin || emax > modelEmax) {
+    G4cout << "/B3/adjoint/beamOn: fluxes cover " << emin/keV << " - " << emax/keV
+           << " keV, the adjoint models " << modelEmin/keV << " - " << modelEmax/keV
+           << " keV (/B3/adjoint/modelRange): the rest is not simulated" << G4endl;
+    emin = std::max(emin, modelEmin);
+    emax = std::min(emax, modelEmax);
+  }
+  if (emax <= emin) {
+    G4cerr << "/B3/adjoint/beamOn: no energy in common with the adjoint models" << G4endl;
+    return;
+  }
+
+  // adjoint source on the gas, external source = the forward sphere
+  auto* manager = G4AdjointSimManager::GetInstance();
+  if (!manager->DefineAdjointSourceOnTheExtSurfaceOfAVolume("TPCGas")
+      || !manager->DefineSphericalExtSource(fSphereRadius, G4ThreeVector())) {
+    G4cerr << "/B3/adjoint/beamOn: cannot define the sources (after /run/initialize?)" << G4endl;
+    return;
+  }
+  manager->SetAdjointSourceEmin(emin);
+  manager->SetAdjointSourceEmax(emax);
+  manager->SetExtSourceEmax(emax);
+  for (const G4String particle : {"gamma", "e-"}) {
+    const G4bool used = std::any_of(gComponents.begin(), gComponents.end(),
+                                    [&particle](const Component& c) { return c.particle == particle; });
+    if (used) manager->ConsiderParticleAsPrimary(particle);
+    else      manager->NeglectParticleAsPrimary(particle);
+  }
+
+  gRunning = true;
+  manager->RunAdjointSimulation(events);
+  gRunning = false;
+}
+
+void AdjointFlux::BeginOfRun()
+{
+  if (!IsRunning()) return;
+
+  for (auto& c : gComponents) c.spectrum.Reset(fNBins);
+  gTotal.Reset(fNBins);
+  gEvents = gReached = 0;
+}
+
+void AdjointFlux::EndOfEvent(G4double edep)
+{
+  if (!IsRunning()) return;
+
+  // adjoint tracks of this event that reached the sphere
+  auto* manager = G4AdjointSimManager::GetInstance();
+  const std::size_t nTracks = manager->GetNbOfAdointTracksReachingTheExternalSurface();
+  for (auto& c : gComponents) c.event = 0.;
+  for (std::size_t i = 0; i < nTracks; ++i) {
+    const G4int    pdg = manager->GetFwdParticlePDGEncodingAtEndOfLastAdjointTrack(i);
+    const G4double e   = manager->GetEkinAtEndOfLastAdjointTrack(i);
+    const G4double w   = manager->GetWeightAtEndOfLastAdjointTrack(i);
+    for (auto& c : gComponents) {
+      if (c.pdg == pdg) c.event += w * Interpolate(c.energy, c.flux, e);
+    }
+  }
+  manager->ClearEndOfAdjointTrackInfoVectors();
+
+  ++gEvents;
+  if (edep <= 0. || nTracks == 0) return;
+  ++gReached;
+
+  const G4int bin = (edep < fEdepMin || edep >= fEdepMax) ? -1
+                  : G4int((edep - fEdepMin) / (fEdepMax - fEdepMin) * fNBins);
+  G4double total = 0.;
+  for (auto& c : gComponents) {
+    c.spectrum.Add(bin, c.event);
+    total += c.event;
+  }
+  gTotal.Add(bin, total);
+}
+
+void AdjointFlux::EndOfRun(G4int runID, const std::string& dir)
+{
+  if (!IsRunning() || gEvents == 0) return;
+
+  // mean over the events, and its error
+  const G4double n = G4double(gEvents);
+  auto rate = [n](G4double sum) { return sum / n; };
+  auto error = [n](G4double sum2) { return std::sqrt(sum2) / n; };
+
+  const std::string file = (dir.empty() ? std::string() : dir + "/")
+                         + "adjoint_run" + std::to_string(runID) + ".txt";
+  std::ofstream out(file);
+  out << "# reverse MC: rate of gas energy deposits [counts/s per bin] for the isotropic\n"
+      << "# fluxes on a sphere of " << fSphereRadius/cm << " cm, " << gEvents << " adjoint events\n"
+      << "# edep_low_keV edep_high_keV";
+  for (const auto& c : gComponents) out << " " << c.name << " " << c.name << "_err";
+  out << " total total_err\n";
+
+  const G4double width = (fEdepMax - fEdepMin) / fNBins;
+  for (G4int b = 0; b < fNBins; ++b) {
+    out << (fEdepMin + b * width)/keV << " " << (fEdepMin + (b + 1) * width)/keV;
+    for (const auto& c : gComponents) {
+      out << " " << rate(c.spectrum.sum[b]) << " " << error(c.spectrum.sum2[b]);
+    }
+    out << " " << rate(gTotal.sum[b]) << " " << error(gTotal.sum2[b]) << "\n";
+  }
+
+  G4cout << "\n---- Adjoint run " << runID << ": " << gEvents << " events, " << gReached
+         << " with a deposit and a track on the sphere, " << file << " ----\n"
+         << "  component        particle   rate with a deposit [counts/s]" << G4endl;
+  for (const auto& c : gComponents) {
+    G4cout << "  " << std::left << std::setw(17) << c.name << std::setw(11) << c.particle
+           << std::right << std::scientific << std::setprecision(3)
+           << rate(c.spectrum.any) << " +- " << error(c.spectrum.any2)
+           << std::defaultfloat << std::setprecision(6) << G4endl;
+  }
+  G4cout << "  " << std::left << std::setw(28) << "total" << std::right << std::scientific
+         << std::setprecision(3) << rate(gTotal.any) << " +- " << error(gTotal.any2)
+         << std::defaultfloat << std::setprecision(6) << G4endl
+         << "--------------------------------------" << G4endl;
+}
+
+} // namespace B3a
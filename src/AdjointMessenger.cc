@@ -0,0 +1,133 @@
+/// \file B3/B3a/src/AdjointMessenger.cc
+/// \brief Implementation of the B3a::AdjointMessenger class
+
+#include "AdjointMessenger.hh"
+#include "AdjointFlux.hh"
+#include "AdjointPhysics.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+#include <sstream>
+
+namespace B3a {
+
+AdjointMessenger::AdjointMessenger()
+{
+  fDir = new G4UIdirectory("/B3/adjoint/");
+  fDir->SetGuidance("Reverse (adjoint) Monte Carlo of isotropic background fluxes;");
+  fDir->SetGuidance("start the job with exampleB3a --adjoint <macro>");
+
+  fFluxCmd = new G4UIcommand("/B3/adjoint/flux", this);
+  fFluxCmd->SetGuidance("name file particle: add (or replace) a flux component");
+  fFluxCmd->SetGuidance("  file: E[MeV], Phi [cm^-2 s^-1 sr^-1 MeV^-1] per line");
+  fFluxCmd->SetGuidance("  particle: gamma or e-");
+  fFluxCmd->SetParameter(new G4UIparameter("name", 's', false));
+  fFluxCmd->SetParameter(new G4UIparameter("file", 's', false));
+  auto* particle = new G4UIparameter("particle", 's', false);
+  particle->SetParameterCandidates("gamma e-");
+  fFluxCmd->SetParameter(particle);
+  fFluxCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fFluxCmd->SetToBeBroadcasted(false);
+
+  fEdepBinsCmd = new G4UIcommand("/B3/adjoint/edepBins", this);
+  fEdepBinsCmd->SetGuidance("n emin emax unit: bins of the gas deposit spectrum (200 0 100 keV)");
+  auto* n = new G4UIparameter("n", 'i', false);
+  n->SetParameterRange("n > 0");
+  fEdepBinsCmd->SetParameter(n);
+  fEdepBinsCmd->SetParameter(new G4UIparameter("emin", 'd', false));
+  fEdepBinsCmd->SetParameter(new G4UIparameter("emax", 'd', false));
+  auto* unit = new G4UIparameter("unit", 's', true);
+  unit->SetDefaultValue("keV");
+  fEdepBinsCmd->SetParameter(unit);
+  fEdepBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fEdepBinsCmd->SetToBeBroadcasted(false);
+
+  fSphereRadiusCmd = new G4UIcmdWithADoubleAndUnit("/B3/adjoint/sphereRadius", this);
+  fSphereRadiusCmd->SetGuidance("Radius of the sphere the fluxes come from (default 50 cm,");
+  fSphereRadiusCmd->SetGuidance("as the forward sphere source)");
+  fSphereRadiusCmd->SetParameterName("radius", false);
+  fSphereRadiusCmd->SetRange("radius > 0.");
+  fSphereRadiusCmd->SetUnitCategory("Length");
+  fSphereRadiusCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSphereRadiusCmd->SetToBeBroadcasted(false);
+
+  fModelRangeCmd = new G4UIcommand("/B3/adjoint/modelRange", this);
+  fModelRangeCmd->SetGuidance("emin emax unit: energy range of the adjoint models (1 keV - 10 MeV)");
+  fModelRangeCmd->SetParameter(new G4UIparameter("emin", 'd', false));
+  fModelRangeCmd->SetParameter(new G4UIparameter("emax", 'd', false));
+  unit = new G4UIparameter("unit", 's', true);
+  unit->SetDefaultValue("keV");
+  fModelRangeCmd->SetParameter(unit);
+  fModelRangeCmd->AvailableForStates(G4State_PreInit);
+  fModelRangeCmd->SetToBeBroadcasted(false);
+
+  fBeamOnCmd = new G4UIcmdWithAnInteger("/B3/adjoint/beamOn", this);
+  fBeamOnCmd->SetGuidance("Run this many adjoint events and write adjoint_run<R>.txt");
+  fBeamOnCmd->SetParameterName("events", false);
+  fBeamOnCmd->SetRange("events > 0");
+  fBeamOnCmd->AvailableForStates(G4State_Idle);
+  fBeamOnCmd->SetToBeBroadcasted(false);
+}
+
+AdjointMessenger::~AdjointMessenger()
+{
+  delete fFluxCmd;
+  delete fEdepBinsCmd;
+  delete fSphereRadiusCmd;
+  delete fModelRangeCmd;
+  delete fBeamOnCmd;
+  delete fDir;
+}
+
+void AdjointMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  if (cmd == fFluxCmd) {
+
+    std::istringstream is(value);
+    G4String name, file, particle;
+    is >> name >> file >> particle;
+    AdjointFlux::AddComponent(name, file, particle);
+
+  } else if (cmd == fEdepBinsCmd) {
+
+    std::istringstream is(value);
+    G4int n;
+    G4double emin, emax;
+    G4String unit;
+    is >> n >> emin >> emax >> unit;
+    if (emax <= emin || emin < 0.) {
+      G4cerr << "/B3/adjoint/edepBins: 0 <= emin < emax is needed" << G4endl;
+      return;
+    }
+    const G4double u = G4UIcommand::ValueOf(unit);
+    AdjointFlux::SetEdepBins(n, emin * u, emax * u);
+
+  } else if (cmd == fSphereRadiusCmd) {
+
+    AdjointFlux::SetSphereRadius(fSphereRadiusCmd->GetNewDoubleValue(value));
+
+  } else if (cmd == fModelRangeCmd) {
+
+    std::istringstream is(value);
+    G4double emin, emax;
+    G4String unit;
+    is >> emin >> emax >> unit;
+    if (emax <= emin || emin <= 0.) {
+      G4cerr << "/B3/adjoint/modelRange: 0 < emin < emax is needed" << G4endl;
+      return;
+    }
+    const G4double u = G4UIcommand::ValueOf(unit);
+    B3::AdjointPhysics::SetModelRange(emin * u, emax * u);
+
+  } else if (cmd == fBeamOnCmd) {
+
+    AdjointFlux::BeamOn(fBeamOnCmd->GetNewIntValue(value));
+
+  }
+}
+
+} // namespace B3a
@@ -0,0 +1,131 @@
+/// \file B3/B3a/src/AdjointPhysics.cc
+/// \brief Implementation of the B3::AdjointPhysics class
+
+#include "AdjointPhysics.hh"
+
+#include "G4AdjointCSManager.hh"
+#include "G4AdjointElectron.hh"
+#include "G4AdjointGamma.hh"
+#include "G4Electron.hh"
+#include "G4Gamma.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessTable.hh"
+#include "G4VEnergyLossProcess.hh"
+#include "G4VEmProcess.hh"
+
+#include "G4AdjointAlongStepWeightCorrection.hh"
+#include "G4AdjointBremsstrahlungModel.hh"
+#include "G4AdjointComptonModel.hh"
+#include "G4AdjointeIonisationModel.hh"
+#include "G4AdjointPhotoElectricModel.hh"
+#include "G4ContinuousGainOfEnergy.hh"
+#include "G4eAdjointMultipleScattering.hh"
+#include "G4eInverseBremsstrahlung.hh"
+#include "G4eInverseCompton.hh"
+#include "G4eInverseIonisation.hh"
+#include "G4InversePEEffect.hh"
+#include "G4UrbanMscModel.hh"
+
+#include <vector>
+
+namespace B3
+{
+
+AdjointPhysics::AdjointPhysics()
+  : G4VPhysicsConstructor("AdjointEm")
+{}
+
+void AdjointPhysics::ConstructParticle()
+{
+  G4AdjointGamma::AdjointGamma();
+  G4AdjointElectron::AdjointElectron();
+}
+
+void AdjointPhysics::ConstructProcess()
+{
+  auto* gamma       = G4Gamma::Gamma();
+  auto* electron    = G4Electron::Electron();
+  auto* adjGamma    = G4AdjointGamma::AdjointGamma();
+  auto* adjElectron = G4AdjointElectron::AdjointElectron();
+
+  // forward processes of the EM physics, for the adjoint cross sections
+  auto* table = G4ProcessTable::GetProcessTable();
+  auto* eIoni = dynamic_cast<G4VEnergyLossProcess*>(table->FindProcess("eIoni", electron));
+  auto* eBrem = dynamic_cast<G4VEnergyLossProcess*>(table->FindProcess("eBrem", electron));
+  auto* compt = dynamic_cast<G4VEmProcess*>(table->FindProcess("compt", gamma));
+  auto* phot  = dynamic_cast<G4VEmProcess*>(table->FindProcess("phot", gamma));
+  if (!eIoni || !eBrem || !compt || !phot) {
+    G4Exception("AdjointPhysics::ConstructProcess", "B3_ADJOINT_PHYSICS", FatalException,
+                "Forward eIoni, eBrem, compt or phot not found: the adjoint physics must be "
+                "registered after the EM physics, with G4GammaGeneralProcess off.");
+    return;
+  }
+
+  auto* csManager = G4AdjointCSManager::GetAdjointCSManager();
+  csManager->RegisterAdjointParticle(adjElectron);
+  csManager->RegisterAdjointParticle(adjGamma);
+  csManager->RegisterEnergyLossProcess(eIoni, electron);
+  csManager->RegisterEnergyLossProcess(eBrem, electron);
+  csManager->RegisterEmProcess(compt, gamma);
+  csManager->RegisterEmProcess(phot, gamma);
+
+  // adjoint models (they register themselves with the CS manager)
+  auto* ionModel   = new G4AdjointeIonisationModel();
+  auto* bremModel  = new G4AdjointBremsstrahlungModel();
+  auto* comptModel = new G4AdjointComptonModel();
+  auto* peModel    = new G4AdjointPhotoElectricModel();
+  for (G4VEmAdjointModel* model : std::vector<G4VEmAdjointModel*>{ionModel, bremModel,
+                                                                   comptModel, peModel}) {
+    model->SetLowEnergyLimit(fEmin);
+    model->SetHighEnergyLimit(fEmax);
+  }
+  comptModel->SetSecondPartOfSameType(false);
+  comptModel->SetUseMatrix(false);
+  comptModel->SetDirectProcess(compt);
+
+  // reverse reactions: true = the projectile stays (proj -> proj),
+  // false = a secondary becomes the projectile (prod -> proj)
+  auto* invIonProj   = new G4eInverseIonisation(true,  "Inv_eIon",   ionModel);
+  auto* invIonProd   = new G4eInverseIonisation(false, "Inv_eIon1",  ionModel);
+  auto* invBremProj  = new G4eInverseBremsstrahlung(true,  "Inv_eBrem",  bremModel);
+  auto* invBremProd  = new G4eInverseBremsstrahlung(false, "Inv_eBrem1", bremModel);
+  auto* invComptProj = new G4eInverseCompton(true,  "Inv_Compt",  comptModel);
+  auto* invComptProd = new G4eInverseCompton(false, "Inv_Compt1", comptModel);
+  auto* invPE        = new G4InversePEEffect("Inv_PEEffect", peModel);
+
+  // adj_e-: gain of energy along the step, then the reverse reactions
+  auto* pm = adjElectron->GetProcessManager();
+  auto* msc = new G4eAdjointMultipleScattering();
+  msc->SetEmModel(new G4UrbanMscModel());
+  auto* gain = new G4ContinuousGainOfEnergy();
+  gain->SetLossFluctuations(true);
+  gain->SetDirectEnergyLossProcess(eIoni);
+  gain->SetDirectParticle(electron);
+  auto* electronWeight = new G4AdjointAlongStepWeightCorrection();
+
+  pm->AddProcess(msc);
+  pm->AddProcess(gain);
+  pm->AddProcess(electronWeight);
+  pm->SetProcessOrdering(msc, idxAlongStep, 1);
+  pm->SetProcessOrdering(gain, idxAlongStep, 2);
+  pm->SetProcessOrdering(electronWeight, idxAlongStep, 3);
+  G4int order = 0;
+  for (G4VProcess* p : std::vector<G4VProcess*>{invIonProj, invIonProd, invBremProj,
+                                                 invComptProd, invPE}) {
+    pm->AddProcess(p);
+    pm->SetProcessOrdering(p, idxPostStep, ++order);
+  }
+  pm->SetProcessOrdering(msc, idxPostStep, ++order);
+
+  // adj_gamma
+  pm = adjGamma->GetProcessManager();
+  auto* gammaWeight = new G4AdjointAlongStepWeightCorrection();
+  pm->AddProcess(gammaWeight);
+  pm->SetProcessOrdering(gammaWeight, idxAlongStep, 1);
+  pm->AddProcess(invBremProd);
+  pm->SetProcessOrdering(invBremProd, idxPostStep, 1);
+  pm->AddProcess(invComptProj);
+  pm->SetProcessOrdering(invComptProj, idxPostStep, 2);
+}
+
+}
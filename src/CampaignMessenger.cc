@@ -0,0 +1,50 @@
+/// \file B3/B3a/src/CampaignMessenger.cc
+
+#include "CampaignMessenger.hh"
+#include "CampaignRunner.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+namespace B3 {
+
+CampaignMessenger::CampaignMessenger(CampaignRunner* runner)
+  : fRunner(runner)
+{
+  fDir = new G4UIdirectory("/B3/campaign/");
+  fDir->SetGuidance("Run many configurations in one process");
+
+  fRunCmd = new G4UIcommand("/B3/campaign/run", this);
+  fRunCmd->SetGuidance("Run every point of a campaign table: run <table> [summary file]");
+  fRunCmd->SetGuidance("(see CampaignRunner.hh or the README for the columns)");
+  auto* pTable = new G4UIparameter("table", 's', false);
+  auto* pSummary = new G4UIparameter("summary", 's', true);
+  pSummary->SetDefaultValue("campaign_summary.txt");
+  fRunCmd->SetParameter(pTable);
+  fRunCmd->SetParameter(pSummary);
+  fRunCmd->AvailableForStates(G4State_Idle);
+  fRunCmd->SetToBeBroadcasted(false);
+}
+
+CampaignMessenger::~CampaignMessenger()
+{
+  delete fRunCmd;
+  delete fDir;
+}
+
+void CampaignMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  if (cmd == fRunCmd) {
+
+    std::istringstream is(value);
+    G4String table, summary;
+    is >> table >> summary;
+    fRunner->Run(table, summary);
+
+  }
+}
+
+} // namespace B3
@@ -0,0 +1,219 @@
+/// \file B3/B3a/src/CampaignRunner.cc
+/// \brief Implementation of the B3::CampaignRunner class
+
+#include "CampaignRunner.hh"
+#include "CampaignMessenger.hh"
+#include "RunAction.hh"
+
+#include "G4UImanager.hh"
+#include "G4Timer.hh"
+#include "G4Exception.hh"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace B3 {
+
+namespace {
+  // column -> (command, unit appended to the value)
+  const std::map<G4String, std::pair<G4String, G4String>> kColumns = {
+    {"spectrum",     {"/B3/primary/spectrumFile", ""}},
+    {"particle",     {"/B3/primary/particle",     ""}},
+    {"mode",         {"/B3/primary/emissionMode", ""}},
+    {"sphereRadius", {"/B3/primary/sphereRadius", "cm"}},
+    {"pressure",     {"/B3/det/pressure",         "atmosphere"}},
+    {"fractions",    {"/B3/det/fractions",        ""}},
+    {"radius",       {"/B3/det/gasRadius",        "mm"}},
+    {"thickness",    {"/B3/det/gasThickness",     "mm"}},
+  };
+
+  // events column; std::stol alone throws on "abc" and accepts "10k"
+  G4bool ParseEvents(const G4String& value, G4long& events)
+  {
+    try {
+      std::size_t used = 0;
+      events = std::stol(value, &used);
+      return used == value.size() && events >= 0;
+    } catch (const std::exception&) {
+      return false;
+    }
+  }
+}
+
+CampaignRunner::CampaignRunner()
+{
+  fMessenger = new CampaignMessenger(this);
+}
+
+CampaignRunner::~CampaignRunner()
+{
+  delete fMessenger;
+}
+
+G4bool CampaignRunner::ReadTable(const G4String& table, std::vector<Point>& points) const
+{
+  std::ifstream in(table);
+  if (!in) {
+    G4Exception("CampaignRunner::ReadTable", "B3Camp001", JustWarning,
+                ("Cannot open campaign table " + table).c_str());
+    return false;
+  }
+
+  std::vector<G4String> columns;
+  std::string line;
+  G4int lineNo = 0;
+  while (std::getline(in, line)) {
+    ++lineNo;
+    const auto hash = line.find('#');
+    if (hash != std::string::npos) line.erase(hash);
+
+    std::istringstream is(line);
+    std::vector<G4String> fields;
+    for (std::string f; is >> f;) fields.emplace_back(f);
+    if (fields.empty()) continue;
+
+    if (columns.empty()) {
+      columns = fields;
+      for (const auto& c : columns) {
+        if (c != "tag" && c != "events" && c[0] != '/' && !kColumns.count(c)) {
+          G4Exception("CampaignRunner::ReadTable", "B3Camp002", JustWarning,
+                      ("Unknown campaign column " + c).c_str());
+          return false;
+        }
+      }
+      if (std::find(columns.begin(), columns.end(), "tag") == columns.end() ||
+          std::find(columns.begin(), columns.end(), "events") == columns.end()) {
+        G4Exception("CampaignRunner::ReadTable", "B3Camp003", JustWarning,
+                    "The campaign table needs a 'tag' and an 'events' column.");
+        return false;
+      }
+      continue;
+    }
+
+    if (fields.size() != columns.size()) {
+      G4cerr << "CampaignRunner: " << table << ":" << lineNo << " has "
+             << fields.size() << " fields for " << columns.size()
+             << " columns, skipped" << G4endl;
+      continue;
+    }
+
+    Point p;
+    G4bool valid = true;
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+      if      (columns[i] == "tag")    p.tag = fields[i];
+      else if (columns[i] != "events") p.settings.emplace_back(columns[i], fields[i]);
+      else if (!ParseEvents(fields[i], p.events)) {
+        G4cerr << "CampaignRunner: " << table << ":" << lineNo << ": events must be an"
+               << " integer >= 0, not '" << fields[i] << "', skipped" << G4endl;
+        valid = false;
+      }
+    }
+    if (valid) points.push_back(std::move(p));
+  }
+  return true;
+}
+
+G4String CampaignRunner::CommandFor(const G4String& column, const G4String& value) const
+{
+  if (column[0] == '/') return column + " " + value;
+
+  const auto& [command, unit] = kColumns.at(column);
+  G4String v = value;
+  std::replace(v.begin(), v.end(), ',', ' ');
+  return command + " " + v + (unit.empty() ? "" : " " + unit);
+}
+
+void CampaignRunner::Run(const G4String& table, const G4String& summaryFile)
+{
+  std::vector<Point> points;
+  if (!ReadTable(table, points)) return;
+
+  auto* UImanager = G4UImanager::GetUIpointer();
+  const G4String outputDir = B3a::RunAction::GetOutputDirectory();
+
+  std::vector<Timing> timings;
+  G4Timer setupTimer, runTimer;
+
+  for (const auto& p : points) {
+    Timing timing;
+    timing.tag    = p.tag;
+    timing.events = p.events;
+
+    G4cout << "==== campaign point " << p.tag << " (" << p.events << " events) ====" << G4endl;
+
+    // apply only what changed since the previous point
+    setupTimer.Start();
+    G4bool ok = true;
+    for (const auto& [column, value] : p.settings) {
+      if (value == "-") continue;
+      auto it = fApplied.find(column);
+      if (it != fApplied.end() && it->second == value) continue;
+
+      const G4String command = CommandFor(column, value);
+      if (UImanager->ApplyCommand(command) != 0) {
+        G4cerr << "CampaignRunner: '" << command << "' failed, point "
+               << p.tag << " skipped" << G4endl;
+        fApplied.erase(column);
+        ok = false;
+        break;
+      }
+      fApplied[column] = value;
+    }
+    setupTimer.Stop();
+    timing.setup = setupTimer.GetRealElapsed();
+
+    if (ok) {
+      std::error_code ec;
+      std::filesystem::create_directories(std::string(p.tag), ec);
+      B3a::RunAction::SetOutputDirectory(p.tag);
+
+      runTimer.Start();
+      ok = (UImanager->ApplyCommand("/run/beamOn " + std::to_string(p.events)) == 0);
+      runTimer.Stop();
+      timing.wall = runTimer.GetRealElapsed();
+      timing.user = runTimer.GetUserElapsed();
+    }
+    timing.ok = ok;
+    timings.push_back(timing);
+  }
+
+  B3a::RunAction::SetOutputDirectory(outputDir);
+  PrintSummary(timings, summaryFile);
+}
+
+void CampaignRunner::PrintSummary(const std::vector<Timing>& timings,
+                                  const G4String& summaryFile) const
+{
+  std::ostringstream os;
+  os << std::left << std::setw(24) << "# tag" << std::right
+     << std::setw(12) << "events" << std::setw(12) << "setup_s"
+     << std::setw(12) << "wall_s" << std::setw(12) << "user_s"
+     << std::setw(14) << "ms_per_event" << std::setw(8) << "ok" << "\n";
+
+  G4double setup = 0., wall = 0.;
+  for (const auto& t : timings) {
+    setup += t.setup;
+    wall  += t.wall;
+    os << std::left << std::setw(24) << t.tag << std::right
+       << std::setw(12) << t.events
+       << std::fixed << std::setprecision(3)
+       << std::setw(12) << t.setup << std::setw(12) << t.wall
+       << std::setw(12) << t.user
+       << std::setw(14) << (t.events > 0 ? 1e3*t.wall/t.events : 0.)
+       << std::setw(8) << (t.ok ? 1 : 0) << "\n";
+  }
+
+  G4cout << "---- Campaign summary (" << timings.size() << " points, setup "
+         << setup << " s, runs " << wall << " s) ----\n" << os.str() << G4endl;
+
+  if (!summaryFile.empty()) {
+    std::ofstream out(summaryFile);
+    out << os.str();
+  }
+}
+
+} // namespace B3
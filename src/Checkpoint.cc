@@ -0,0 +1,206 @@
+/// \file B3/B3a/src/Checkpoint.cc
+/// \brief Implementation of the B3a::Checkpoint class
+
+#include "Checkpoint.hh"
+
+#include "G4RunManager.hh"
+#include "G4MTRunManager.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace B3a {
+
+namespace {
+// events must be seeded one by one for the event ID -> seeds map to hold
+void SeedEveryEvent()
+{
+  if (auto* mt = dynamic_cast<G4MTRunManager*>(G4RunManager::GetRunManager())) {
+    mt->SetSeedOncePerCommunication(0);
+  }
+}
+
+// one 64-bit mixing step (splitmix64), for seeds that differ from event to event
+std::uint64_t Mix(std::uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+std::string EngineFile(G4int runID, const std::string& dir)
+{
+  const std::string f = "checkpoint_run" + std::to_string(runID) + ".rndm";
+  return dir.empty() ? f : dir + "/" + f;
+}
+}
+
+void Checkpoint::SetInterval(G4int events)
+{
+  fInterval = events;
+  if (fInterval > 0) SeedEveryEvent();
+}
+
+G4bool Checkpoint::Resume(const std::string& dir)
+{
+  fResume  = true;
+  fAttempt = 1;   // never the names of the interrupted job
+  fDone.clear();
+  fLoaded.clear();
+  SeedEveryEvent();
+  return Load(dir);
+}
+
+G4bool Checkpoint::Load(const std::string& dir)
+{
+  namespace fs = std::filesystem;
+  const fs::path path = dir.empty() ? fs::path(".") : fs::path(dir);
+  std::error_code ec;
+  if (!fLoaded.insert(fs::weakly_canonical(path, ec).string()).second) return false;
+
+  std::map<G4int, Ranges> found;
+  G4int lastAttempt = -1;
+  for (const auto& entry : fs::directory_iterator(path, ec)) {
+    const std::string name = entry.path().filename().string();
+    if (name.rfind("tpc_hits_", 0) != 0 || entry.path().extension() != ".ckpt") continue;
+
+    std::ifstream in(entry.path());
+    std::string line, key;
+    G4int runID = -1, attempt = 0;
+    Ranges ranges;
+    while (std::getline(in, line)) {
+      std::istringstream is(line);
+      if (line.rfind("attempt", 0) == 0)     is >> key >> attempt;
+      else if (line.rfind("run", 0) == 0)    is >> key >> runID;
+      else if (line.rfind("output", 0) == 0) continue;
+      else {
+        G4int first, last;
+        if (is >> first >> last) ranges.emplace_back(first, last);
+      }
+    }
+    if (runID < 0) continue;
+    lastAttempt = std::max(lastAttempt, attempt);
+    Append(found[runID], ranges);
+  }
+
+  if (lastAttempt < 0) return false;
+
+  // several threads, several attempts: sort and merge
+  for (auto& [runID, add] : found) {
+    auto& ranges = fDone[runID];
+    ranges.insert(ranges.end(), add.begin(), add.end());
+    std::sort(ranges.begin(), ranges.end());
+    Ranges merged;
+    for (const auto& r : ranges) {
+      if (!merged.empty() && r.first <= merged.back().second + 1) {
+        merged.back().second = std::max(merged.back().second, r.second);
+      } else {
+        merged.push_back(r);
+      }
+    }
+    ranges.swap(merged);
+
+    std::size_t n = 0;
+    for (const auto& r : ranges) n += std::size_t(r.second - r.first + 1);
+    G4cout << "---- Resume (" << path.string() << "): run " << runID << ", " << n
+           << " events already written ----" << G4endl;
+  }
+
+  fAttempt = std::max(fAttempt, lastAttempt + 1);
+  return true;
+}
+
+void Checkpoint::StartRun(G4int runID, const std::string& dir)
+{
+  if (!IsEnabled()) return;
+
+  if (fResume) Load(dir);   // the output directory of this run
+
+  const std::string file = EngineFile(runID, dir);
+  if (fResume) {
+    if (std::ifstream(file).good()) {
+      G4Random::restoreEngineStatus(file.c_str());
+    } else {
+      G4cerr << "Checkpoint: no " << file << ", the events of run " << runID
+             << " will not continue the interrupted ones" << G4endl;
+    }
+  } else {
+    G4Random::saveEngineStatus(file.c_str());
+  }
+
+  // serial: the events use no seeds of their own, and a skipped event
+  // draws no random numbers; seed each one from the run seeds instead
+  fSerial = !dynamic_cast<G4MTRunManager*>(G4RunManager::GetRunManager());
+  if (fSerial) {
+    fRunSeeds[0] = G4long(1.e9 * G4UniformRand());
+    fRunSeeds[1] = G4long(1.e9 * G4UniformRand());
+  }
+}
+
+void Checkpoint::SeedEvent(G4int eventID)
+{
+  if (!IsEnabled() || !fSerial) return;
+
+  const std::uint64_t id = std::uint32_t(eventID);
+  long seeds[3] = {
+    long(Mix(std::uint64_t(fRunSeeds[0]) ^ (id << 32)) % 900000000ULL + 1),
+    long(Mix(std::uint64_t(fRunSeeds[1]) ^ id)         % 900000000ULL + 1),
+    0 };
+  G4Random::setTheSeeds(seeds);
+}
+
+G4bool Checkpoint::IsDone(G4int runID, G4int eventID)
+{
+  if (!fResume) return false;
+  const auto run = fDone.find(runID);
+  if (run == fDone.end()) return false;
+
+  const auto& ranges = run->second;
+  auto it = std::upper_bound(ranges.begin(), ranges.end(), std::make_pair(eventID, eventID),
+    [](const auto& a, const auto& b) { return a.first < b.first; });
+  if (it == ranges.begin()) return false;
+  --it;
+  return eventID <= it->second;
+}
+
+void Checkpoint::AddEvent(Ranges& ranges, G4int eventID)
+{
+  if (!ranges.empty() && ranges.back().second + 1 == eventID) {
+    ranges.back().second = eventID;
+  } else {
+    ranges.emplace_back(eventID, eventID);
+  }
+}
+
+void Checkpoint::Append(Ranges& to, const Ranges& from)
+{
+  for (const auto& r : from) {
+    if (!to.empty() && to.back().second + 1 == r.first) {
+      to.back().second = r.second;
+    } else {
+      to.push_back(r);
+    }
+  }
+}
+
+void Checkpoint::Write(const std::string& file, G4int runID,
+                       const std::string& output, const Ranges& done)
+{
+  const std::string tmp = file + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::trunc);
+    out << "attempt " << fAttempt << "\n"
+        << "run " << runID << "\n"
+        << "output " << output << "\n";
+    for (const auto& r : done) out << r.first << " " << r.second << "\n";
+  }
+  std::rename(tmp.c_str(), file.c_str());
+}
+
+} // namespace B3a
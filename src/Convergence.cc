@@ -0,0 +1,166 @@
+/// \file B3/B3a/src/Convergence.cc
+/// \brief Implementation of the B3a::Convergence class
+
+#include "Convergence.hh"
+#include "ModulationCurve.hh"
+
+#include "G4RunManager.hh"
+#include "G4AutoLock.hh"
+#include "G4Threading.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace B3a {
+
+namespace {
+G4Mutex gTotalMutex = G4MUTEX_INITIALIZER;
+Convergence::Stats gTotal;   // shared totals of the run
+
+// this thread's events since its last hand-over
+G4ThreadLocal Convergence::Stats* localStats = nullptr;
+}
+
+const char* Convergence::Name(Target t)
+{
+  switch (t) {
+    case kRate: return "rate";
+    case kEdep: return "edep";
+    case kMu:   return "mu";
+    default:    return "none";
+  }
+}
+
+void Convergence::BeginOfRun()
+{
+  if (!IsEnabled()) return;
+
+  const std::size_t nPhi = (fTarget == kMu) ? ModulationCurve::GetPhiBins() : 0;
+  if (G4Threading::IsMasterThread()) {
+    G4AutoLock lock(&gTotalMutex);
+    gTotal.Reset(nPhi);
+    fLastCheck = 0;
+    fReached = false;
+    fMasterRunManager = G4RunManager::GetRunManager();
+
+    if (fTarget == kMu && ModulationCurve::EnergyBin(fEnergy) < 0) {
+      G4cerr << "/B3/convergence/target mu: " << fEnergy/keV
+             << " keV is outside the /B3/modulation/energyBins range" << G4endl;
+    }
+  }
+
+  if (!localStats) localStats = new Stats;
+  localStats->Reset(nPhi);
+}
+
+void Convergence::AddPhotoelectron(G4double energy, const G4ThreeVector& photonDir,
+                                   const G4ThreeVector& electronDir)
+{
+  if (fTarget != kMu || !localStats) return;
+  const G4int iE = ModulationCurve::EnergyBin(energy);
+  if (iE < 0 || iE != ModulationCurve::EnergyBin(fEnergy)) return;
+  const G4int iPhi = ModulationCurve::PhiBin(photonDir, electronDir);
+  if (iPhi >= 0 && iPhi < G4int(localStats->phi.size())) localStats->phi[iPhi] += 1;
+}
+
+void Convergence::AddEvent(G4double edep, G4bool weighted)
+{
+  if (!IsEnabled() || !localStats) return;
+
+  auto& s = *localStats;
+  s.n += 1;
+  if (edep > 0.) s.nHit += 1;
+  if (weighted) s.nWeighted += 1;
+  s.sumE  += edep;
+  s.sumE2 += edep * edep;
+
+  // hand over about every checkEvery / nThreads events
+  const G4int nThreads = std::max(1, G4Threading::GetNumberOfRunningWorkerThreads());
+  if (s.n < std::max(1, fCheckEvery / nThreads)) return;
+
+  G4bool abort = false;
+  {
+    G4AutoLock lock(&gTotalMutex);
+    gTotal.Add(s);
+
+    if (!fReached && gTotal.n >= fMinEvents && gTotal.n - fLastCheck >= fCheckEvery) {
+      fLastCheck = gTotal.n;
+      G4double value = 0.;
+      const G4double precision = Precision(gTotal, value);
+      if (precision >= 0. && precision <= fPrecision) fReached = abort = true;
+    }
+  }
+  s.Reset(s.phi.size());
+
+  // soft abort of the whole run: the master stops handing out events
+  if (abort && fMasterRunManager) fMasterRunManager->AbortRun(true);
+}
+
+G4double Convergence::Precision(const Stats& s, G4double& value)
+{
+  value = 0.;
+  if (s.n < 2) return -1.;
+
+  if (fTarget == kRate) {
+    // binomial fraction p = nHit / n
+    if (s.nHit == 0) return -1.;
+    const G4double p = G4double(s.nHit) / s.n;
+    value = p;
+    return std::sqrt((1. - p) / (p * s.n));
+  }
+  if (fTarget == kEdep) {
+    const G4double mean = s.sumE / s.n;
+    if (mean <= 0.) return -1.;
+    const G4double var = std::max(0., (s.sumE2 / s.n - mean * mean) * s.n / (s.n - 1));
+    value = mean;
+    return std::sqrt(var / s.n) / mean;
+  }
+  if (fTarget == kMu) {
+    const auto fit = ModulationCurve::FitBin(s.phi.data(), G4int(s.phi.size()));
+    if (!fit.ok) return -1.;
+    value = fit.mu;
+    return fit.muErr;
+  }
+  return -1.;
+}
+
+void Convergence::EndOfRun()
+{
+  if (!IsEnabled()) return;
+
+  if (localStats) {
+    G4AutoLock lock(&gTotalMutex);
+    gTotal.Add(*localStats);
+    localStats->Reset(localStats->phi.size());
+  }
+  if (!G4Threading::IsMasterThread()) return;
+
+  G4double value = 0.;
+  const G4double precision = Precision(gTotal, value);
+  const G4bool met = precision >= 0. && precision <= fPrecision;
+
+  G4cout << "\n---- Convergence (" << Name(fTarget);
+  if (fTarget == kMu) G4cout << " at " << fEnergy/keV << " keV";
+  G4cout << "): target " << fPrecision
+         << (fTarget == kMu ? " (error)" : " (relative error)") << " "
+         << (met ? "met" : "NOT met") << (fReached ? ", run stopped early" : ", whole budget used")
+         << " ----\n"
+         << "  events used: " << gTotal.n << "\n";
+  if (precision < 0.) {
+    G4cout << "  precision: not estimable (no events of the target)" << G4endl;
+  } else {
+    G4cout << "  estimate:  ";
+    if (fTarget == kEdep) G4cout << value/keV << " keV per primary";
+    else                  G4cout << value;
+    G4cout << "\n  precision: " << precision << G4endl;
+  }
+  if (gTotal.nWeighted > 0 && fTarget != kEdep) {
+    G4cout << "  WARNING: " << gTotal.nWeighted << " events carry importance weights;"
+           << " the " << Name(fTarget) << " target counts them unweighted and is not valid"
+           << " under biasing (use edep)" << G4endl;
+  }
+  G4cout << "--------------------------------------" << G4endl;
+}
+
+} // namespace B3a
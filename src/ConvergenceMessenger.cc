@@ -0,0 +1,97 @@
+/// \file B3/B3a/src/ConvergenceMessenger.cc
+/// \brief Implementation of the B3a::ConvergenceMessenger class
+
+#include "ConvergenceMessenger.hh"
+#include "Convergence.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+#include <sstream>
+
+namespace B3a {
+
+ConvergenceMessenger::ConvergenceMessenger()
+{
+  fDir = new G4UIdirectory("/B3/convergence/");
+  fDir->SetGuidance("Stop the run once a statistical target is met;");
+  fDir->SetGuidance("the /run/beamOn count is the event budget");
+
+  fTargetCmd = new G4UIcommand("/B3/convergence/target", this);
+  fTargetCmd->SetGuidance("quantity precision [energy unit]");
+  fTargetCmd->SetGuidance("  rate: relative error of the fraction of primaries with a gas deposit");
+  fTargetCmd->SetGuidance("  edep: relative error of the mean gas deposit per primary");
+  fTargetCmd->SetGuidance("  mu:   error of the modulation factor at a photon energy");
+  fTargetCmd->SetGuidance("        (its /B3/modulation/energyBins bin), e.g. mu 0.01 8 keV");
+  fTargetCmd->SetGuidance("  none: no target (default)");
+  auto* q = new G4UIparameter("quantity", 's', false);
+  q->SetParameterCandidates("none rate edep mu");
+  fTargetCmd->SetParameter(q);
+  auto* precision = new G4UIparameter("precision", 'd', true);
+  precision->SetDefaultValue(0.);
+  precision->SetParameterRange("precision >= 0.");
+  fTargetCmd->SetParameter(precision);
+  auto* energy = new G4UIparameter("energy", 'd', true);
+  energy->SetDefaultValue(0.);
+  fTargetCmd->SetParameter(energy);
+  auto* unit = new G4UIparameter("unit", 's', true);
+  unit->SetDefaultValue("keV");
+  fTargetCmd->SetParameter(unit);
+  fTargetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTargetCmd->SetToBeBroadcasted(false);
+
+  fCheckEveryCmd = new G4UIcmdWithAnInteger("/B3/convergence/checkEvery", this);
+  fCheckEveryCmd->SetGuidance("Check the precision every this many events (all threads, default 1000)");
+  fCheckEveryCmd->SetParameterName("events", false);
+  fCheckEveryCmd->SetRange("events > 0");
+  fCheckEveryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCheckEveryCmd->SetToBeBroadcasted(false);
+
+  fMinEventsCmd = new G4UIcmdWithAnInteger("/B3/convergence/minEvents", this);
+  fMinEventsCmd->SetGuidance("Never stop before this many events (default 1000)");
+  fMinEventsCmd->SetParameterName("events", false);
+  fMinEventsCmd->SetRange("events >= 0");
+  fMinEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMinEventsCmd->SetToBeBroadcasted(false);
+}
+
+ConvergenceMessenger::~ConvergenceMessenger()
+{
+  delete fTargetCmd;
+  delete fCheckEveryCmd;
+  delete fMinEventsCmd;
+  delete fDir;
+}
+
+void ConvergenceMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  if (cmd == fTargetCmd) {
+
+    std::istringstream is(value);
+    G4String q, unit;
+    G4double precision, energy;
+    is >> q >> precision >> energy >> unit;
+    if (q != "none" && precision <= 0.) {
+      G4cerr << "/B3/convergence/target: a precision > 0 is needed" << G4endl;
+      return;
+    }
+    if      (q == "rate") Convergence::SetTarget(Convergence::kRate, precision);
+    else if (q == "edep") Convergence::SetTarget(Convergence::kEdep, precision);
+    else if (q == "mu")   Convergence::SetTarget(Convergence::kMu, precision,
+                                                 energy * G4UIcommand::ValueOf(unit));
+    else                  Convergence::SetTarget(Convergence::kNone, 0.);
+
+  } else if (cmd == fCheckEveryCmd) {
+
+    Convergence::SetCheckEvery(fCheckEveryCmd->GetNewIntValue(value));
+
+  } else if (cmd == fMinEventsCmd) {
+
+    Convergence::SetMinEvents(fMinEventsCmd->GetNewIntValue(value));
+
+  }
+}
+
+} // namespace B3a
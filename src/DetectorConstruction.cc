@@ -7,19 +7,60 @@
 #include "G4PVPlacement.hh"
 #include "G4SDManager.hh"
 #include "G4MultiFunctionalDetector.hh"
-#include "G4PSEnergyDeposit.hh"
 #include "G4VisAttributes.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Region.hh"
 #include "G4ProductionCuts.hh"
 #include "G4Tubs.hh"
+#include "G4RegionStore.hh"
+#include "G4RunManager.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4UnitsTable.hh"
+#include "G4Exception.hh"
+
+#include <cmath>
+
+#include "ElectronTrackLibraryMessenger.hh"
+#include "ElectronTrackLibraryModel.hh"
+#include "ImportanceWorld.hh"
+#include "DetectorMessenger.hh"
+#include "PixelReadoutScorer.hh"
+#include "GasSD.hh"
+#include "PixelReadoutMessenger.hh"
 
 namespace B3 {
 
-DetectorConstruction::DetectorConstruction() {  }
+DetectorConstruction::DetectorConstruction()
+{
+  fFastSimMessenger = new ElectronTrackLibraryMessenger();
+  fMessenger        = new DetectorMessenger(this);
+  fReadoutMessenger = new PixelReadoutMessenger();
+
+  // importance shells for G4ImportanceBiasing (/B3/bias/); the parallel
+  // world is only navigated if /B3/phys/importanceBiasing is used
+  RegisterParallelWorld(new ImportanceWorld());
+}
+
+DetectorConstruction::~DetectorConstruction()
+{
+  delete fFastSimMessenger;
+  delete fMessenger;
+  delete fReadoutMessenger;
+}
 
 G4VPhysicalVolume* DetectorConstruction::Construct()
 {
+  // Called again after /B3/det/ changes (ReinitializeGeometry): only the
+  // gas material and the gas cylinder are updated, the volumes (and the
+  // sensitive detector / fast simulation attached to them) are kept.
+  if (fWorldPV) {
+    if (fMaterialModified) fGasLV->SetMaterial(BuildGasMaterial());
+    if (fShapeModified)    UpdateGasShape();
+    fMaterialModified = fShapeModified = false;
+    return fWorldPV;
+  }
+
   // ✅ define nist here
   auto* nist = G4NistManager::Instance();
 
@@ -27,74 +68,92 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   auto* worldMat   = nist->FindOrBuildMaterial("G4_Galactic");
   auto* solidWorld = new G4Box("World", 50*cm, 50*cm, 50*cm);
   auto* logicWorld = new G4LogicalVolume(solidWorld, worldMat, "World");
-  auto* physWorld  = new G4PVPlacement(
+  fWorldPV = new G4PVPlacement(
       nullptr, {}, logicWorld, "World", nullptr, false, 0, fCheckOverlaps);
 
   //! Gas (active TPC volume)
-  //defining detector gas mixture
+  auto* CYGNO_gas = BuildGasMaterial();
+
+  //! Creating the TPC gas volume
   //
 
-  G4double aHe = 4.002602*g/mole;
-  G4Element* elHe = new G4Element("Helium","He", 2, aHe);
+  fGasSolid = new G4Tubs("TPCGas", 0, fGasRadius, fGasThickness / 2, 0, 360 * deg);
+  fGasLV    = new G4LogicalVolume(fGasSolid, CYGNO_gas, "TPCGasLV");
+
+  // place cylinder so that one endcap (flat face) is centered at the origin (z=0)
+  G4ThreeVector gasPos(0., 0., fGasThickness / 2.); // center shifted +dz so lower face sits at z=0
+  fGasPV = new G4PVPlacement(nullptr, gasPos, fGasLV, "TPCGas",
+                             logicWorld, false, 0, fCheckOverlaps);
+
+  // Optional visibility
+  fGasLV->SetVisAttributes(new G4VisAttributes(G4Colour(0.68, 0.85, 0.9))); // Light blue and fully colored
+
+  // Region for the TPC gas; its cuts (1 µm by default) and limits are
+  // set by PhysicsList (/B3/cuts/, /B3/limits/)
+  auto* gasRegion = new G4Region("TPCGasRegion");
+  auto* gasCuts   = new G4ProductionCuts();
+  gasCuts->SetProductionCut(0.001*mm);
+  gasRegion->SetProductionCuts(gasCuts);
 
-  //density 1394
-  G4double aAr = 39.948*g/mole;
-  G4Element* elAr = new G4Element("Argon","Ar", 18, aAr);
+  // Attach region to the gas logical volume
+  fGasLV->SetRegion(gasRegion);
+  gasRegion->AddRootLogicalVolume(fGasLV);
 
-  G4double aC = 12.0107*g/mole;
-  G4Element* elC = new G4Element("Carbon", "C", 6, aC);
-  
-  G4double aF=18.998*g/mole;
-  G4Element* elF = new G4Element("Fluorine"  ,"F" , 9., aF);
+  fMaterialModified = fShapeModified = false;
 
-  G4double aS =87.62*g/mole;
-  G4Element* elS = new G4Element("Sulfur","S",16,aS);
+  // ✅ must return the world physical volume
+  return fWorldPV;
+}
 
-  // User knobs
-  G4double gasPressure    = 1 * atmosphere;  // <-- you change only this
-  G4double gasTemperature = 300*kelvin;
+//! Detector gas mixture from the /B3/det/ parameters. Every call makes
+//! new materials (with a version suffix after the first one): a
+//! G4Material cannot be changed once the couples refer to it.
+G4Material* DetectorConstruction::BuildGasMaterial()
+{
+  const G4String suffix = (fGasVersion == 0) ? "" : "_" + std::to_string(fGasVersion);
+  ++fGasVersion;
+
+  auto element = [](const G4String& name, const G4String& symbol, G4double z, G4double a) {
+    auto* el = G4Element::GetElement(name, false);
+    return el ? el : new G4Element(name, symbol, z, a);
+  };
 
-  // Fractions (sum to 1.0 in volume/partial pressure sense)
-  G4double He_frac  = 0.6;
-  G4double CF4_frac = 0.4;
-  G4double Ar_frac  = 0.;
-  G4double SF6_frac = 0.;
+  G4Element* elHe = element("Helium",   "He", 2,  4.002602*g/mole);
+  G4Element* elAr = element("Argon",    "Ar", 18, 39.948*g/mole);
+  G4Element* elC  = element("Carbon",   "C",  6,  12.0107*g/mole);
+  G4Element* elF  = element("Fluorine", "F",  9., 18.998*g/mole);
+  G4Element* elS  = element("Sulfur",   "S",  16, 87.62*g/mole);
 
-  // Reference densities at 1 atm, 300 K for *pure* gas
-  // (your numbers were these *times* the fraction already; we separate it)
-  G4double rhoHe_ref   = 162.488  * g/m3;   // He @1 atm
-  G4double rhoCF4_ref  = 3574.736 * g/m3;   // CF4 @1 atm
-  G4double rhoAr_ref   = 1394.0   * g/m3;   // Ar @1 atm
-  G4double rhoSF6_ref  = 6010.368 * g/m3;   // SF6 @1 atm
+  G4double gasTemperature = 300*kelvin;
 
   // Scale by total pressure and by fraction
   // ρ_component = ρ_ref * (gasPressure / 1 atm) * fraction
-  G4double densityHe   = rhoHe_ref  * (gasPressure/atmosphere) * He_frac;
-  G4double densityCF4  = rhoCF4_ref * (gasPressure/atmosphere) * CF4_frac;
-  G4double densityAr   = rhoAr_ref  * (gasPressure/atmosphere) * Ar_frac;
-  G4double densitySF6  = rhoSF6_ref * (gasPressure/atmosphere) * SF6_frac;
+  G4double densityHe   = fRhoHeRef  * (fGasPressure/atmosphere) * fHeFrac;
+  G4double densityCF4  = fRhoCF4Ref * (fGasPressure/atmosphere) * fCF4Frac;
+  G4double densityAr   = fRhoArRef  * (fGasPressure/atmosphere) * fArFrac;
+  G4double densitySF6  = fRhoSF6Ref * (fGasPressure/atmosphere) * fSF6Frac;
 
   // Partial pressures (still useful to store)
-  G4double pressureHe   = gasPressure * He_frac;
-  G4double pressureCF4  = gasPressure * CF4_frac;
-  G4double pressureAr   = gasPressure * Ar_frac;
-  G4double pressureSF6  = gasPressure * SF6_frac;
+  G4double pressureHe   = fGasPressure * fHeFrac;
+  G4double pressureCF4  = fGasPressure * fCF4Frac;
+  G4double pressureAr   = fGasPressure * fArFrac;
+  G4double pressureSF6  = fGasPressure * fSF6Frac;
 
   // Build each component material
-  auto* He_gas = new G4Material("He_gas",  densityHe, 1,
+  auto* He_gas = new G4Material("He_gas" + suffix,  densityHe, 1,
                                 kStateGas, gasTemperature, pressureHe);
   He_gas->AddElement(elHe,1);
 
-  auto* CF4_gas = new G4Material("CF4_gas", densityCF4, 2,
+  auto* CF4_gas = new G4Material("CF4_gas" + suffix, densityCF4, 2,
                                 kStateGas, gasTemperature, pressureCF4);
   CF4_gas->AddElement(elC,1);
   CF4_gas->AddElement(elF,4);
 
-  auto* Ar_gas = new G4Material("Ar_gas", densityAr, 1,
+  auto* Ar_gas = new G4Material("Ar_gas" + suffix, densityAr, 1,
                                 kStateGas, gasTemperature, pressureAr);
   Ar_gas->AddElement(elAr,1);
 
-  auto* SF6_gas = new G4Material("SF6_gas", densitySF6, 2,
+  auto* SF6_gas = new G4Material("SF6_gas" + suffix, densitySF6, 2,
                                 kStateGas, gasTemperature, pressureSF6);
   SF6_gas->AddElement(elS,1);
   SF6_gas->AddElement(elF,6);
@@ -103,7 +162,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   G4double densityMix   = densityHe + densityCF4 + densityAr + densitySF6;
   G4double pressureMix  = pressureHe + pressureCF4 + pressureAr + pressureSF6;
 
-  auto* CYGNO_gas = new G4Material("CYGNO_gas", densityMix, 4,
+  auto* CYGNO_gas = new G4Material("CYGNO_gas" + suffix, densityMix, 4,
                                   kStateGas, gasTemperature, pressureMix);
 
   // Add components by MASS FRACTION = componentMass / totalMass
@@ -112,45 +171,133 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   CYGNO_gas->AddMaterial(Ar_gas,  densityAr  / densityMix);
   CYGNO_gas->AddMaterial(SF6_gas, densitySF6 / densityMix);
 
-  //! Creating the TPC gas volume
-  //
+  return CYGNO_gas;
+}
+
+void DetectorConstruction::UpdateGasShape()
+{
+  fGasSolid->SetOuterRadius(fGasRadius);
+  fGasSolid->SetZHalfLength(fGasThickness / 2.);
+  fGasPV->SetTranslation(G4ThreeVector(0., 0., fGasThickness / 2.));
+}
 
-  G4double GasRadius = 36.9 * mm;
-  G4double GasThickness = 50 * mm;
+// --------------------------------------------------
+// /B3/det/ setters. Before /run/initialize they only change the values;
+// afterwards the next run rebuilds the gas (see Construct()).
+// --------------------------------------------------
+void DetectorConstruction::SetGasPressure(G4double p)
+{
+  fGasPressure = p;
+  MaterialModified();
+}
 
-  auto* solidGas = new G4Tubs("TPCGas", 0, GasRadius, GasThickness / 2, 0, 360 * deg);
-  auto* logicGas = new G4LogicalVolume(solidGas, CYGNO_gas, "TPCGasLV");
+void DetectorConstruction::SetGasFractions(G4double he, G4double cf4,
+                                           G4double ar, G4double sf6)
+{
+  const G4double sum = he + cf4 + ar + sf6;
+  if (!(sum > 0.)) {
+    G4Exception("DetectorConstruction::SetGasFractions", "B3Det001",
+                JustWarning, "Fractions must add up to a positive value; ignored.");
+    return;
+  }
+  if (std::abs(sum - 1.) > 1e-6) {
+    G4cout << "DetectorConstruction: gas fractions add up to " << sum
+           << ", normalised to 1" << G4endl;
+  }
+  fHeFrac  = he  / sum;
+  fCF4Frac = cf4 / sum;
+  fArFrac  = ar  / sum;
+  fSF6Frac = sf6 / sum;
+  MaterialModified();
+}
 
-  // place cylinder so that one endcap (flat face) is centered at the origin (z=0)
-  G4ThreeVector gasPos(0., 0., GasThickness / 2.); // center shifted +dz so lower face sits at z=0
-  new G4PVPlacement(nullptr, gasPos, logicGas, "TPCGas",
-                    logicWorld, false, 0, fCheckOverlaps);
+void DetectorConstruction::SetReferenceDensity(const G4String& gas, G4double rho)
+{
+  if      (gas == "He")  fRhoHeRef  = rho;
+  else if (gas == "CF4") fRhoCF4Ref = rho;
+  else if (gas == "Ar")  fRhoArRef  = rho;
+  else if (gas == "SF6") fRhoSF6Ref = rho;
+  else {
+    G4Exception("DetectorConstruction::SetReferenceDensity", "B3Det002",
+                JustWarning, ("Unknown gas component " + gas).c_str());
+    return;
+  }
+  MaterialModified();
+}
 
-  // Optional visibility
-  logicGas->SetVisAttributes(new G4VisAttributes(G4Colour(0.68, 0.85, 0.9))); // Light blue and fully colored
+void DetectorConstruction::SetGasRadius(G4double r)
+{
+  fGasRadius = r;
+  ShapeModified();
+}
 
-  // Region-specific cuts for the TPC gas (fine, low-energy secondaries)
-  auto* gasRegion = new G4Region("TPCGasRegion");
-  auto* gasCuts   = new G4ProductionCuts();
-  gasCuts->SetProductionCut(0.001*mm); // ~1 µm — aggressive for gas
-  gasRegion->SetProductionCuts(gasCuts);
+void DetectorConstruction::SetGasThickness(G4double dz)
+{
+  fGasThickness = dz;
+  ShapeModified();
+}
 
-  // Attach region to the gas logical volume
-  logicGas->SetRegion(gasRegion);
-  gasRegion->AddRootLogicalVolume(logicGas);
+void DetectorConstruction::MaterialModified()
+{
+  fMaterialModified = true;
+  if (!fWorldPV) return;
+  // new couple for the gas: its cuts and physics tables
+  G4RunManager::GetRunManager()->ReinitializeGeometry();
+  G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+}
 
-  // ✅ must return the world physical volume
-  return physWorld;
+void DetectorConstruction::ShapeModified()
+{
+  fShapeModified = true;
+  if (!fWorldPV) return;
+  G4RunManager::GetRunManager()->ReinitializeGeometry();
+}
+
+void DetectorConstruction::Print() const
+{
+  G4cout << "---- TPC gas ----\n"
+         << "  pressure  : " << G4BestUnit(fGasPressure, "Pressure") << "\n"
+         << "  fractions : He " << fHeFrac << ", CF4 " << fCF4Frac
+         << ", Ar " << fArFrac << ", SF6 " << fSF6Frac << "\n"
+         << "  ref. density @ 1 atm (kg/m3) : He " << fRhoHeRef/(kg/m3)
+         << ", CF4 " << fRhoCF4Ref/(kg/m3) << ", Ar " << fRhoArRef/(kg/m3)
+         << ", SF6 " << fRhoSF6Ref/(kg/m3) << "\n"
+         << "  radius    : " << G4BestUnit(fGasRadius, "Length") << "\n"
+         << "  thickness : " << G4BestUnit(fGasThickness, "Length") << "\n";
+  if (fGasLV) {
+    G4cout << "  material  : " << fGasLV->GetMaterial()->GetName() << ", "
+           << G4BestUnit(fGasLV->GetMaterial()->GetDensity(), "Volumic Mass") << "\n";
+  }
+  G4cout << G4endl;
 }
 
 void DetectorConstruction::ConstructSDandField()
 {
+  // called again on every thread after a geometry reinitialisation;
+  // the volumes are the same, so is what is attached to them (the SD
+  // manager is per thread)
+  auto* sdManager = G4SDManager::GetSDMpointer();
+  if (sdManager->FindSensitiveDetector("gasSD", false)) return;
+
+  // hits of the gas ("steps" tree)
+  auto* gasSD = new GasSD("gasSD");
+  sdManager->AddNewDetector(gasSD);
+
+  // readout plane: sparse pixel list per event (/B3/readout/)
   auto* gas = new G4MultiFunctionalDetector("gas");
-  G4SDManager::GetSDMpointer()->AddNewDetector(gas);
-  gas->RegisterPrimitive(new G4PSEnergyDeposit("edep"));
+  sdManager->AddNewDetector(gas);
+  auto* pixels = new PixelReadoutScorer("pixels");
+  gas->RegisterPrimitive(pixels);
 
-  // Attach by logical volume name (as in B3a pattern)
+  // Attach by logical volume name (as in B3a pattern); two detectors on
+  // one volume are wrapped in a G4MultiSensitiveDetector
+  SetSensitiveDetector("TPCGasLV", gasSD);
   SetSensitiveDetector("TPCGasLV", gas);
+
+  // Fast simulation of keV electrons in the gas; it only triggers once a
+  // track library is loaded (/B3/fastsim/library)
+  auto* gasRegion = G4RegionStore::GetInstance()->GetRegion("TPCGasRegion");
+  new ElectronTrackLibraryModel("ElectronTrackLibrary", gasRegion, gasSD, pixels);
 }
 
 } // namespace B3
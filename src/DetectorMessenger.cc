@@ -0,0 +1,123 @@
+/// \file B3/B3a/src/DetectorMessenger.cc
+
+#include "DetectorMessenger.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+namespace B3 {
+
+DetectorMessenger::DetectorMessenger(DetectorConstruction* detector)
+  : fDetector(detector)
+{
+  fDir = new G4UIdirectory("/B3/det/");
+  fDir->SetGuidance("TPC gas and geometry. Changes after /run/initialize take effect");
+  fDir->SetGuidance("at the next /run/beamOn (only the gas is rebuilt).");
+
+  fPressureCmd = new G4UIcmdWithADoubleAndUnit("/B3/det/pressure", this);
+  fPressureCmd->SetGuidance("Total gas pressure");
+  fPressureCmd->SetParameterName("p", false);
+  fPressureCmd->SetRange("p > 0.");
+  fPressureCmd->SetDefaultUnit("atmosphere");
+
+  fFractionsCmd = new G4UIcommand("/B3/det/fractions", this);
+  fFractionsCmd->SetGuidance("Volume (partial pressure) fractions: fractions <He> <CF4> <Ar> <SF6>");
+  fFractionsCmd->SetGuidance("normalised to 1 if they do not add up");
+  for (const char* name : {"He", "CF4", "Ar", "SF6"}) {
+    auto* p = new G4UIparameter(name, 'd', false);
+    p->SetParameterRange(G4String(name) + " >= 0.");
+    fFractionsCmd->SetParameter(p);
+  }
+
+  fRefDensCmd = new G4UIcommand("/B3/det/refDensity", this);
+  fRefDensCmd->SetGuidance("Density of a pure component at 1 atm, 300 K:");
+  fRefDensCmd->SetGuidance("  refDensity <He|CF4|Ar|SF6> <value> [unit=kg/m3]");
+  auto* pGas = new G4UIparameter("gas", 's', false);
+  pGas->SetParameterCandidates("He CF4 Ar SF6");
+  auto* pValue = new G4UIparameter("value", 'd', false);
+  pValue->SetParameterRange("value > 0.");
+  auto* pUnit = new G4UIparameter("unit", 's', true);
+  pUnit->SetDefaultValue("kg/m3");
+  fRefDensCmd->SetParameter(pGas);
+  fRefDensCmd->SetParameter(pValue);
+  fRefDensCmd->SetParameter(pUnit);
+
+  fRadiusCmd = new G4UIcmdWithADoubleAndUnit("/B3/det/gasRadius", this);
+  fRadiusCmd->SetGuidance("Radius of the gas cylinder");
+  fRadiusCmd->SetParameterName("r", false);
+  fRadiusCmd->SetRange("r > 0.");
+  fRadiusCmd->SetDefaultUnit("mm");
+
+  fThickCmd = new G4UIcmdWithADoubleAndUnit("/B3/det/gasThickness", this);
+  fThickCmd->SetGuidance("Length of the gas cylinder (lower face stays at z = 0)");
+  fThickCmd->SetParameterName("dz", false);
+  fThickCmd->SetRange("dz > 0.");
+  fThickCmd->SetDefaultUnit("mm");
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/B3/det/print", this);
+  fPrintCmd->SetGuidance("Print the gas parameters");
+
+  // geometry lives on the master; the reinitialisation reaches the workers
+  for (G4UIcommand* cmd : {static_cast<G4UIcommand*>(fPressureCmd), fFractionsCmd,
+                           fRefDensCmd, static_cast<G4UIcommand*>(fRadiusCmd),
+                           static_cast<G4UIcommand*>(fThickCmd),
+                           static_cast<G4UIcommand*>(fPrintCmd)}) {
+    cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    cmd->SetToBeBroadcasted(false);
+  }
+}
+
+DetectorMessenger::~DetectorMessenger()
+{
+  delete fPressureCmd;
+  delete fFractionsCmd;
+  delete fRefDensCmd;
+  delete fRadiusCmd;
+  delete fThickCmd;
+  delete fPrintCmd;
+  delete fDir;
+}
+
+void DetectorMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  if (cmd == fPressureCmd) {
+
+    fDetector->SetGasPressure(fPressureCmd->GetNewDoubleValue(value));
+
+  } else if (cmd == fFractionsCmd) {
+
+    std::istringstream is(value);
+    G4double he, cf4, ar, sf6;
+    is >> he >> cf4 >> ar >> sf6;
+    fDetector->SetGasFractions(he, cf4, ar, sf6);
+
+  } else if (cmd == fRefDensCmd) {
+
+    std::istringstream is(value);
+    G4String gas, unit;
+    G4double v;
+    is >> gas >> v >> unit;
+    fDetector->SetReferenceDensity(gas, v*G4UIcommand::ValueOf(unit));
+
+  } else if (cmd == fRadiusCmd) {
+
+    fDetector->SetGasRadius(fRadiusCmd->GetNewDoubleValue(value));
+
+  } else if (cmd == fThickCmd) {
+
+    fDetector->SetGasThickness(fThickCmd->GetNewDoubleValue(value));
+
+  } else if (cmd == fPrintCmd) {
+
+    fDetector->Print();
+
+  }
+}
+
+} // namespace B3
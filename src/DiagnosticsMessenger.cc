@@ -0,0 +1,140 @@
+/// \file B3/B3a/src/DiagnosticsMessenger.cc
+
+#include "DiagnosticsMessenger.hh"
+#include "SteppingAction.hh"
+#include "Timing.hh"
+#include "StepProfiler.hh"
+#include "HitBuffer.hh"
+#include "Progress.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4SystemOfUnits.hh"
+
+namespace B3a {
+
+DiagnosticsMessenger::DiagnosticsMessenger()
+{
+  fDir = new G4UIdirectory("/B3/diag/");
+  fDir->SetGuidance("Optional diagnostics (they cost time: off by default)");
+
+  fStepsCmd = new G4UIcmdWithABool("/B3/diag/steps", this);
+  fStepsCmd->SetGuidance("Count the steps in the world and in the gas (stepping action).");
+  fStepsCmd->SetGuidance("Set before the first /run/beamOn.");
+  fStepsCmd->SetParameterName("flag", true);
+  fStepsCmd->SetDefaultValue(true);
+  fStepsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStepsCmd->SetToBeBroadcasted(false);
+
+  fTimingCmd = new G4UIcmdWithABool("/B3/diag/timing", this);
+  fTimingCmd->SetGuidance("Time per stage and thread, reported at the end of each run.");
+  fTimingCmd->SetGuidance("Needs a build with -DB3_TIMING=ON; set before the first /run/beamOn.");
+  fTimingCmd->SetParameterName("flag", true);
+  fTimingCmd->SetDefaultValue(true);
+  fTimingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTimingCmd->SetToBeBroadcasted(false);
+
+  fJsonCmd = new G4UIcmdWithAString("/B3/diag/timingJson", this);
+  fJsonCmd->SetGuidance("Also write the timing report of every run of the job to this JSON file");
+  fJsonCmd->SetParameterName("file", false);
+  fJsonCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fJsonCmd->SetToBeBroadcasted(false);
+
+  fProfileCmd = new G4UIcmdWithABool("/B3/diag/profile", this);
+  fProfileCmd->SetGuidance("Steps and time per (particle, defining process, logical volume),");
+  fProfileCmd->SetGuidance("ranked at the end of each run. Set before the first /run/beamOn.");
+  fProfileCmd->SetParameterName("flag", true);
+  fProfileCmd->SetDefaultValue(true);
+  fProfileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fProfileCmd->SetToBeBroadcasted(false);
+
+  fTopCmd = new G4UIcmdWithAnInteger("/B3/diag/profileTop", this);
+  fTopCmd->SetGuidance("Rows of the step profile to print (default 25)");
+  fTopCmd->SetParameterName("rows", false);
+  fTopCmd->SetRange("rows > 0");
+  fTopCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTopCmd->SetToBeBroadcasted(false);
+
+  fMemoryCmd = new G4UIcmdWithABool("/B3/diag/memory", this);
+  fMemoryCmd->SetGuidance("Report hits per event (histogram, peak) and the peak buffer");
+  fMemoryCmd->SetGuidance("memory per thread at the end of each run.");
+  fMemoryCmd->SetParameterName("flag", true);
+  fMemoryCmd->SetDefaultValue(true);
+  fMemoryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMemoryCmd->SetToBeBroadcasted(false);
+
+  fProgressCmd = new G4UIcmdWithADoubleAndUnit("/B3/diag/progress", this);
+  fProgressCmd->SetGuidance("Print events done, events/s, hits/s, MB written and the ETA");
+  fProgressCmd->SetGuidance("every this much wall-clock time during a run (0 = off).");
+  fProgressCmd->SetParameterName("interval", false);
+  fProgressCmd->SetRange("interval >= 0.");
+  fProgressCmd->SetDefaultUnit("s");
+  fProgressCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fProgressCmd->SetToBeBroadcasted(false);
+
+  fStatusCmd = new G4UIcmdWithAString("/B3/diag/statusFile", this);
+  fStatusCmd->SetGuidance("Also rewrite this JSON file at every progress report (and at the");
+  fStatusCmd->SetGuidance("end of the run), for the batch system to poll. Needs /B3/diag/progress.");
+  fStatusCmd->SetParameterName("file", false);
+  fStatusCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStatusCmd->SetToBeBroadcasted(false);
+}
+
+DiagnosticsMessenger::~DiagnosticsMessenger()
+{
+  delete fStepsCmd;
+  delete fTimingCmd;
+  delete fJsonCmd;
+  delete fProfileCmd;
+  delete fTopCmd;
+  delete fMemoryCmd;
+  delete fProgressCmd;
+  delete fStatusCmd;
+  delete fDir;
+}
+
+void DiagnosticsMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  if (cmd == fStepsCmd) {
+
+    SteppingAction::SetEnabled(fStepsCmd->GetNewBoolValue(value));
+
+  } else if (cmd == fTimingCmd) {
+
+    const G4bool on = fTimingCmd->GetNewBoolValue(value);
+    if (on && !Timing::IsCompiled()) {
+      G4cerr << "/B3/diag/timing: built without timing (cmake -DB3_TIMING=ON)" << G4endl;
+    }
+    Timing::SetEnabled(on);
+
+  } else if (cmd == fJsonCmd) {
+
+    Timing::SetJsonFile(value);
+
+  } else if (cmd == fProfileCmd) {
+
+    StepProfiler::SetEnabled(fProfileCmd->GetNewBoolValue(value));
+
+  } else if (cmd == fTopCmd) {
+
+    StepProfiler::SetTop(fTopCmd->GetNewIntValue(value));
+
+  } else if (cmd == fMemoryCmd) {
+
+    HitBuffer::SetReport(fMemoryCmd->GetNewBoolValue(value));
+
+  } else if (cmd == fProgressCmd) {
+
+    Progress::SetInterval(fProgressCmd->GetNewDoubleValue(value) / s);
+
+  } else if (cmd == fStatusCmd) {
+
+    Progress::SetStatusFile(value);
+
+  }
+}
+
+} // namespace B3a
@@ -0,0 +1,312 @@
+/// \file B3/B3a/src/ElectronTrackLibrary.cc
+/// \brief Implementation of the B3::ElectronTrackLibrary class
+
+#include "ElectronTrackLibrary.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Element.hh"
+#include "G4Exception.hh"
+#include "G4ExceptionSeverity.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4Log.hh"
+#include "G4Material.hh"
+#include "Randomize.hh"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace B3 {
+
+namespace {
+  // file layout: magic, emin, emax (MeV), nBins, gas density (g/cm3),
+  // nElements and per element Z, mass fraction; then per bin nTracks and
+  // per track energy (MeV), nDeposits, Deposit[]
+  const char kMagic[8] = {'B','3','E','T','L','I','B','2'};
+
+  // same gas within the precision of the /B3/det/ inputs
+  const G4double kDensityTolerance  = 1.e-3;   // relative
+  const G4double kFractionTolerance = 1.e-4;   // absolute
+}
+
+ElectronTrackLibrary& ElectronTrackLibrary::Instance()
+{
+  static ElectronTrackLibrary instance;
+  return instance;
+}
+
+void ElectronTrackLibrary::ResetBins()
+{
+  fBins.assign(fNBins, {});
+  fNTracks = 0;
+}
+
+G4int ElectronTrackLibrary::BinIndex(G4double energy) const
+{
+  if (energy <= fEmin) return 0;
+  const G4double f = G4Log(energy/fEmin) / G4Log(fEmax/fEmin);
+  const G4int    i = G4int(f * fNBins);
+  return (i < fNBins) ? i : fNBins - 1;
+}
+
+// --------------------------------------------------
+// Use
+// --------------------------------------------------
+G4bool ElectronTrackLibrary::Load(const G4String& filename)
+{
+  std::ifstream fin(filename, std::ios::binary);
+  if (!fin.is_open()) {
+    G4Exception("ElectronTrackLibrary::Load", "B3_TRACKLIB_NOT_FOUND",
+                JustWarning,
+                ("Cannot open track library " + filename +
+                 "; fast simulation stays off.").c_str());
+    return false;
+  }
+
+  char magic[8];
+  fin.read(magic, sizeof(magic));
+  if (!fin || std::memcmp(magic, kMagic, sizeof(magic)) != 0) {
+    G4Exception("ElectronTrackLibrary::Load", "B3_TRACKLIB_BAD_FILE",
+                JustWarning,
+                (filename + " is not an electron track library (libraries"
+                 " without the gas record must be built again).").c_str());
+    return false;
+  }
+
+  // every count is checked against the bytes left before anything is
+  // allocated: a truncated or corrupt file must not drive the reads
+  fin.seekg(0, std::ios::end);
+  const std::uint64_t fileSize = std::uint64_t(fin.tellg());
+  fin.seekg(sizeof(kMagic), std::ios::beg);
+  auto bytesLeft = [&fin, fileSize]() {
+    const std::streamoff pos = fin.tellg();
+    return (fin && pos >= 0) ? fileSize - std::uint64_t(pos) : std::uint64_t(0);
+  };
+  auto corrupt = [this, &filename](const char* what) {
+    G4Exception("ElectronTrackLibrary::Load", "B3_TRACKLIB_TRUNCATED",
+                JustWarning,
+                (filename + ": " + what + "; fast simulation stays off.").c_str());
+    ResetBins();
+    return false;
+  };
+
+  std::int32_t nBins = 0;
+  G4double emin = 0., emax = 0.;
+  fin.read(reinterpret_cast<char*>(&emin), sizeof(emin));
+  fin.read(reinterpret_cast<char*>(&emax), sizeof(emax));
+  fin.read(reinterpret_cast<char*>(&nBins), sizeof(nBins));
+  if (!fin) return corrupt("truncated header");
+  if (!(emin > 0.) || !(emax > emin) || nBins < 1
+      || std::uint64_t(nBins) * sizeof(std::uint64_t) > bytesLeft()) {
+    return corrupt("bad energy range or number of bins");
+  }
+
+  Gas gas;
+  std::int32_t nElements = 0;
+  fin.read(reinterpret_cast<char*>(&gas.density), sizeof(gas.density));
+  fin.read(reinterpret_cast<char*>(&nElements), sizeof(nElements));
+  if (!fin || !(gas.density > 0.) || nElements < 1 || nElements > 120) {
+    return corrupt("bad gas record");
+  }
+  gas.density *= g/cm3;
+  for (std::int32_t i = 0; i < nElements; ++i) {
+    std::int32_t z = 0;
+    G4double fraction = 0.;
+    fin.read(reinterpret_cast<char*>(&z), sizeof(z));
+    fin.read(reinterpret_cast<char*>(&fraction), sizeof(fraction));
+    if (!fin) return corrupt("bad gas record");
+    gas.fractions.emplace_back(z, fraction);
+  }
+
+  fEmin  = emin;
+  fEmax  = emax;
+  fNBins = nBins;
+  fGas   = gas;
+  ResetBins();
+
+  const std::uint64_t trackHeader = sizeof(G4double) + sizeof(std::uint64_t);
+  for (auto& bin : fBins) {
+    std::uint64_t nTracks = 0;
+    fin.read(reinterpret_cast<char*>(&nTracks), sizeof(nTracks));
+    if (!fin || nTracks > bytesLeft() / trackHeader) return corrupt("bad number of tracks");
+    bin.resize(nTracks);
+    for (auto& trk : bin) {
+      std::uint64_t nDep = 0;
+      fin.read(reinterpret_cast<char*>(&trk.energy), sizeof(trk.energy));
+      fin.read(reinterpret_cast<char*>(&nDep), sizeof(nDep));
+      if (!fin || nDep > bytesLeft() / sizeof(Deposit)) return corrupt("bad number of deposits");
+      trk.deposits.resize(nDep);
+      fin.read(reinterpret_cast<char*>(trk.deposits.data()),
+               std::streamsize(nDep * sizeof(Deposit)));
+      if (!fin) return corrupt("truncated track");
+    }
+    fNTracks += bin.size();
+  }
+
+  G4cout << "[ElectronTrackLibrary] Loaded " << fNTracks << " tracks from "
+         << filename << " in " << fNBins << " bins, "
+         << fEmin/keV << " - " << fEmax/keV << " keV, gas "
+         << fGas.density/(g/cm3) << " g/cm3" << G4endl;
+
+  // before /run/initialize there is no gas yet: the first run checks
+  fGasMatches = true;
+  CheckGas();
+  return true;
+}
+
+G4bool ElectronTrackLibrary::CurrentGas(Gas& gas)
+{
+  const auto* lv = G4LogicalVolumeStore::GetInstance()->GetVolume("TPCGasLV", false);
+  const auto* material = lv ? lv->GetMaterial() : nullptr;
+  if (!material) return false;
+
+  gas.density = material->GetDensity();
+  gas.fractions.clear();
+  const auto* elements  = material->GetElementVector();
+  const auto* fractions = material->GetFractionVector();
+  for (std::size_t i = 0; i < material->GetNumberOfElements(); ++i) {
+    gas.fractions.emplace_back(G4int((*elements)[i]->GetZ() + 0.5), fractions[i]);
+  }
+  return true;
+}
+
+G4bool ElectronTrackLibrary::CheckGas()
+{
+  if (fNTracks == 0 || fRecording) return true;
+
+  Gas current;
+  if (!CurrentGas(current)) return fGasMatches;
+
+  // mass fraction of element z, summed over the entries (0 if absent)
+  auto fraction = [](const Gas& gas, G4int z) {
+    G4double sum = 0.;
+    for (const auto& [zi, f] : gas.fractions) if (zi == z) sum += f;
+    return sum;
+  };
+
+  G4bool same = std::abs(current.density - fGas.density) <= kDensityTolerance * fGas.density;
+  for (const auto* gas : {&current, &fGas}) {
+    for (const auto& [z, f] : gas->fractions) {
+      if (std::abs(fraction(current, z) - fraction(fGas, z)) > kFractionTolerance) same = false;
+    }
+  }
+
+  if (!same) {
+    std::ostringstream msg;
+    msg << "The track library was made in a gas of " << fGas.density/(g/cm3)
+        << " g/cm3, the gas is now " << current.density/(g/cm3)
+        << " g/cm3 (or another mixture); fast simulation off until they match."
+        << " Build a library for this gas (/B3/det/ in trackLibrary.mac).";
+    G4Exception("ElectronTrackLibrary::CheckGas", "B3_TRACKLIB_GAS",
+                JustWarning, msg.str().c_str());
+  } else if (!fGasMatches) {
+    G4cout << "[ElectronTrackLibrary] Gas matches the library again: fast simulation on"
+           << G4endl;
+  }
+  fGasMatches = same;
+  return same;
+}
+
+const ElectronTrackLibrary::Track*
+ElectronTrackLibrary::Sample(G4double energy) const
+{
+  const auto& bin = fBins[BinIndex(energy)];
+  if (bin.empty()) return nullptr;
+  std::size_t i = std::size_t(G4UniformRand() * bin.size());
+  if (i >= bin.size()) i = bin.size() - 1;
+  return &bin[i];
+}
+
+// --------------------------------------------------
+// Build
+// --------------------------------------------------
+void ElectronTrackLibrary::SetRecordRange(G4double emin, G4double emax, G4int nBins)
+{
+  if (emin <= 0. || emax <= emin || nBins < 1) {
+    G4Exception("ElectronTrackLibrary::SetRecordRange", "B3_TRACKLIB_RANGE",
+                JustWarning, "Invalid library range; keeping the old one.");
+    return;
+  }
+  fEmin  = emin;
+  fEmax  = emax;
+  fNBins = nBins;
+  ResetBins();
+}
+
+void ElectronTrackLibrary::StartRecording(const G4String& filename)
+{
+  fRecordFile = filename;
+  fRecording  = true;
+  fEnabled    = false;   // the library is made from full simulation
+  ResetBins();
+}
+
+G4double ElectronTrackLibrary::RecordEnergy(G4int eventID) const
+{
+  const G4double dLog = G4Log(fEmax/fEmin) / fNBins;
+  const G4int    bin  = eventID % fNBins;
+  return fEmin * std::exp((bin + G4UniformRand()) * dLog);
+}
+
+void ElectronTrackLibrary::AddTrack(Track&& track)
+{
+  G4AutoLock lock(&fMutex);
+  if (fBins.empty()) ResetBins();
+  fBins[BinIndex(track.energy)].push_back(std::move(track));
+  ++fNTracks;
+}
+
+void ElectronTrackLibrary::Save() const
+{
+  G4AutoLock lock(&fMutex);
+
+  Gas gas;
+  if (!CurrentGas(gas)) {
+    G4Exception("ElectronTrackLibrary::Save", "B3_TRACKLIB_WRITE",
+                JustWarning, "No TPCGasLV: the library is not written.");
+    return;
+  }
+
+  std::ofstream fout(fRecordFile, std::ios::binary | std::ios::trunc);
+  if (!fout.is_open()) {
+    G4Exception("ElectronTrackLibrary::Save", "B3_TRACKLIB_WRITE",
+                JustWarning, ("Cannot write " + fRecordFile).c_str());
+    return;
+  }
+
+  const std::int32_t nBins = fNBins;
+  fout.write(kMagic, sizeof(kMagic));
+  fout.write(reinterpret_cast<const char*>(&fEmin), sizeof(fEmin));
+  fout.write(reinterpret_cast<const char*>(&fEmax), sizeof(fEmax));
+  fout.write(reinterpret_cast<const char*>(&nBins), sizeof(nBins));
+
+  const G4double density = gas.density / (g/cm3);
+  const std::int32_t nElements = std::int32_t(gas.fractions.size());
+  fout.write(reinterpret_cast<const char*>(&density), sizeof(density));
+  fout.write(reinterpret_cast<const char*>(&nElements), sizeof(nElements));
+  for (const auto& [z, fraction] : gas.fractions) {
+    const std::int32_t zz = z;
+    fout.write(reinterpret_cast<const char*>(&zz), sizeof(zz));
+    fout.write(reinterpret_cast<const char*>(&fraction), sizeof(fraction));
+  }
+
+  for (const auto& bin : fBins) {
+    const std::uint64_t nTracks = bin.size();
+    fout.write(reinterpret_cast<const char*>(&nTracks), sizeof(nTracks));
+    for (const auto& trk : bin) {
+      const std::uint64_t nDep = trk.deposits.size();
+      fout.write(reinterpret_cast<const char*>(&trk.energy), sizeof(trk.energy));
+      fout.write(reinterpret_cast<const char*>(&nDep), sizeof(nDep));
+      fout.write(reinterpret_cast<const char*>(trk.deposits.data()),
+                 std::streamsize(nDep * sizeof(Deposit)));
+    }
+  }
+
+  G4cout << "[ElectronTrackLibrary] Wrote " << fNTracks << " tracks to "
+         << fRecordFile << G4endl;
+}
+
+} // namespace B3
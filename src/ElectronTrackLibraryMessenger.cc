@@ -0,0 +1,107 @@
+/// \file B3/B3a/src/ElectronTrackLibraryMessenger.cc
+
+#include "ElectronTrackLibraryMessenger.hh"
+#include "ElectronTrackLibrary.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+#include <sstream>
+
+namespace B3 {
+
+ElectronTrackLibraryMessenger::ElectronTrackLibraryMessenger()
+{
+  fDir = new G4UIdirectory("/B3/fastsim/");
+  fDir->SetGuidance("Track-library fast simulation of low-energy electrons in the gas");
+
+  fEnableCmd = new G4UIcmdWithABool("/B3/fastsim/enable", this);
+  fEnableCmd->SetGuidance("Switch the fast simulation on/off (needs a loaded library)");
+  fEnableCmd->SetParameterName("flag", true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->SetToBeBroadcasted(false);
+
+  fLibraryCmd = new G4UIcmdWithAString("/B3/fastsim/library", this);
+  fLibraryCmd->SetGuidance("Load an electron track library file");
+  fLibraryCmd->SetParameterName("filename", false);
+  fLibraryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fLibraryCmd->SetToBeBroadcasted(false);
+
+  fThresholdCmd = new G4UIcmdWithADoubleAndUnit("/B3/fastsim/threshold", this);
+  fThresholdCmd->SetGuidance("Electrons below this kinetic energy are replaced");
+  fThresholdCmd->SetGuidance("(capped at the upper edge of the library)");
+  fThresholdCmd->SetParameterName("E", false);
+  fThresholdCmd->SetDefaultUnit("keV");
+  fThresholdCmd->SetToBeBroadcasted(false);
+
+  fRecordCmd = new G4UIcmdWithAString("/B3/fastsim/record", this);
+  fRecordCmd->SetGuidance("Build mode: every event is one e- from the gas centre");
+  fRecordCmd->SetGuidance("along +z; the gas deposits are written as a library.");
+  fRecordCmd->SetParameterName("filename", false);
+  fRecordCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRecordCmd->SetToBeBroadcasted(false);
+
+  fRangeCmd = new G4UIcommand("/B3/fastsim/recordRange", this);
+  fRangeCmd->SetGuidance("Energy range and number of log bins of the library to build");
+  auto* pMin = new G4UIparameter("emin", 'd', false);
+  auto* pMax = new G4UIparameter("emax", 'd', false);
+  auto* pUnit = new G4UIparameter("unit", 's', true);
+  pUnit->SetDefaultValue("keV");
+  auto* pBins = new G4UIparameter("nBins", 'i', true);
+  pBins->SetDefaultValue(40);
+  fRangeCmd->SetParameter(pMin);
+  fRangeCmd->SetParameter(pMax);
+  fRangeCmd->SetParameter(pUnit);
+  fRangeCmd->SetParameter(pBins);
+  fRangeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRangeCmd->SetToBeBroadcasted(false);
+}
+
+ElectronTrackLibraryMessenger::~ElectronTrackLibraryMessenger()
+{
+  delete fEnableCmd;
+  delete fLibraryCmd;
+  delete fThresholdCmd;
+  delete fRecordCmd;
+  delete fRangeCmd;
+  delete fDir;
+}
+
+void ElectronTrackLibraryMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  auto& library = ElectronTrackLibrary::Instance();
+
+  if (cmd == fEnableCmd) {
+
+    library.SetEnabled(fEnableCmd->GetNewBoolValue(value));
+
+  } else if (cmd == fLibraryCmd) {
+
+    library.Load(value);
+
+  } else if (cmd == fThresholdCmd) {
+
+    library.SetThreshold(fThresholdCmd->GetNewDoubleValue(value));
+
+  } else if (cmd == fRecordCmd) {
+
+    library.StartRecording(value);
+
+  } else if (cmd == fRangeCmd) {
+
+    std::istringstream is(value);
+    G4double emin, emax;
+    G4String unit;
+    G4int nBins;
+    is >> emin >> emax >> unit >> nBins;
+    const G4double u = G4UIcommand::ValueOf(unit);
+    library.SetRecordRange(emin*u, emax*u, nBins);
+
+  }
+}
+
+} // namespace B3
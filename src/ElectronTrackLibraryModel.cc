@@ -0,0 +1,133 @@
+/// \file B3/B3a/src/ElectronTrackLibraryModel.cc
+/// \brief Implementation of the B3::ElectronTrackLibraryModel class
+
+#include "ElectronTrackLibraryModel.hh"
+#include "ElectronTrackLibrary.hh"
+#include "EventAction.hh"
+#include "PixelReadoutScorer.hh"
+#include "GasSD.hh"
+
+#include "G4Electron.hh"
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4AffineTransform.hh"
+#include "G4VSolid.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <cmath>
+
+namespace B3 {
+
+namespace {
+// electrons: the kinetic energy scales with the track, as the deposits;
+// photons (fluorescence, bremsstrahlung) keep the library momentum
+void ScaleMomentum(G4ThreeVector& mom, G4int pdg, G4double eScale)
+{
+  if (pdg != 11 && pdg != -11) return;
+  const G4double p2 = mom.mag2();
+  if (p2 <= 0.) return;
+  const G4double m = electron_mass_c2;
+  const G4double ekin = (std::sqrt(p2 + m*m) - m) * eScale;
+  mom *= std::sqrt(ekin * (ekin + 2.*m) / p2);
+}
+}
+
+ElectronTrackLibraryModel::ElectronTrackLibraryModel(const G4String& name,
+                                                     G4Region* region,
+                                                     GasSD* gasSD,
+                                                     PixelReadoutScorer* pixels)
+  : G4VFastSimulationModel(name, region), fGasSD(gasSD), fPixels(pixels)
+{}
+
+G4bool ElectronTrackLibraryModel::IsApplicable(const G4ParticleDefinition& p)
+{
+  return &p == G4Electron::Definition();
+}
+
+G4bool ElectronTrackLibraryModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  const auto& library = ElectronTrackLibrary::Instance();
+  if (!library.IsActive()) return false;
+
+  const G4double ekin = fastTrack.GetPrimaryTrack()->GetKineticEnergy();
+  return ekin > 0. && ekin < library.GetThreshold();
+}
+
+void ElectronTrackLibraryModel::DoIt(const G4FastTrack& fastTrack,
+                                     G4FastStep& fastStep)
+{
+  const auto* track = fastTrack.GetPrimaryTrack();
+  const G4double ekin = track->GetKineticEnergy();
+
+  // the electron stops here in any case
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposePrimaryTrackPathLength(0.);
+  fastStep.ProposeTotalEnergyDeposited(0.);   // deposits go in as GasHits
+
+  const auto* libTrack = ElectronTrackLibrary::Instance().Sample(ekin);
+  auto* eventAction = dynamic_cast<B3a::EventAction*>(
+      G4EventManager::GetEventManager()->GetUserEventAction());
+  if (!libTrack || !eventAction || !fGasSD || libTrack->energy <= 0.) return;
+
+  // bins are narrow: rescale the library track to the actual energy,
+  // energies linearly (electron momenta to match) and lengths with the
+  // Kanaya-Okayama range law
+  const G4double eScale = ekin / libTrack->energy;
+  const G4double lScale = std::pow(eScale, 5./3.);
+
+  const G4ThreeVector  pos0  = fastTrack.GetPrimaryTrackLocalPosition();
+  const G4ThreeVector  dir0  = fastTrack.GetPrimaryTrackLocalDirection();
+  const G4VSolid*      solid = fastTrack.GetEnvelopeSolid();
+  const auto*          toGlobal = fastTrack.GetInverseAffineTransformation();
+
+  GasHit h;
+  h.eventID  = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+  h.trackID  = track->GetTrackID();
+  h.parentID = track->GetParentID();
+  eventAction->ResolveAncestry(h.trackID, h.parentID, h.rootID, h.generation);
+  h.weight   = track->GetWeight();
+
+  const auto* cp = track->GetCreatorProcess();
+  h.creatorType    = cp ? cp->GetProcessType()    : -1;
+  h.creatorSubType = cp ? cp->GetProcessSubType() : -1;
+
+  h.isPE      = 0;
+  h.peTrackID = -1;
+
+  const G4double t0 = track->GetGlobalTime();
+
+  for (const auto& d : libTrack->deposits) {
+    G4ThreeVector local(d.x*mm, d.y*mm, d.z*mm);
+    local *= lScale;
+    local.rotateUz(dir0);
+    local += pos0;
+    if (solid->Inside(local) == kOutside) continue;
+
+    if (fPixels) fPixels->AddDeposit(local, solid, d.edep * eScale * h.weight);
+
+    G4ThreeVector mom(d.px, d.py, d.pz);
+    ScaleMomentum(mom, d.pdg, eScale);
+    mom.rotateUz(dir0);
+
+    const G4ThreeVector pos = toGlobal->TransformPoint(local);
+    mom = toGlobal->TransformAxis(mom);
+
+    h.pdg = d.pdg;
+    h.x = pos.x()/mm; h.y = pos.y()/mm; h.z = pos.z()/mm;
+    h.t = t0/ns + d.t*lScale;
+    h.px = mom.x(); h.py = mom.y(); h.pz = mom.z();
+    h.edep    = d.edep * eScale;
+    h.stepLen = d.stepLen * lScale;
+    h.stepType    = d.stepType;
+    h.stepSubType = d.stepSubType;
+
+    fGasSD->AddHit(h);
+  }
+}
+
+} // namespace B3
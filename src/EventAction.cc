@@ -1,17 +1,185 @@
 #include "EventAction.hh"
 #include "RunAction.hh"
+#include "ElectronTrackLibrary.hh"
+#include "PixelReadoutScorer.hh"
+#include "GasSD.hh"
+#include "Checkpoint.hh"
+#include "Histograms.hh"
+#include "ModulationCurve.hh"
+#include "Convergence.hh"
+#include "Timing.hh"
+#include "StepProfiler.hh"
+#include "HitBuffer.hh"
+#include "Progress.hh"
+#include "AdjointFlux.hh"
+
 #include "G4Event.hh"
+#include "G4Run.hh"
+#include "G4RunManager.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
+#include "G4THitsMap.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4SystemOfUnits.hh"
 
 namespace B3a {
 
 EventAction::EventAction(RunAction* runAction)
 : G4UserEventAction(), fRunAction(runAction) {}
 
-void EventAction::BeginOfEventAction(const G4Event*) { Clear(); }
+void EventAction::BeginOfEventAction(const G4Event* event)
+{
+  Clear();
+
+  // --resume: this event is already in the files of the interrupted job
+  const auto* run = G4RunManager::GetRunManager()->GetCurrentRun();
+  fSkipped = run && Checkpoint::IsDone(run->GetRunID(), event->GetEventID());
+  if (fSkipped) {
+    G4RunManager::GetRunManager()->AbortEvent();
+    return;
+  }
+
+  B3_TIMING_CALL(Timing::BeginOfEvent());
+  StepProfiler::BeginOfEvent();
+
+  const auto& readout = B3::PixelReadoutScorer::GetSettings();
+  fKeepSteps = readout.writeSteps || !readout.enabled
+            || B3::ElectronTrackLibrary::Instance().IsRecording();
+}
+
+void EventAction::EndOfEventAction(const G4Event* event)
+{
+  B3_TIME(kEndOfEvent);
+  B3_TIMING_CALL(Timing::EndOfEvent());
+
+  // early abort (StackingAction): counted by the run, not written out;
+  // it still counts as a primary with no deposit (skipped ones do not)
+  if (event->IsAborted()) {
+    Progress::AddEvent(0);
+    if (AdjointFlux::IsRunning()) {
+      AdjointFlux::EndOfEvent(0.);
+      return;
+    }
+    if (!fSkipped) {
+      Histograms::Fill(event, nullptr);
+      Convergence::AddEvent(0.);
+    }
+    return;
+  }
+
+  // adjoint run: the deposit weighs the fluxes, nothing else is filled
+  if (AdjointFlux::IsRunning()) {
+    Progress::AddEvent(0);
+    AdjointFlux::EndOfEvent(fTotalEdepGas*MeV);
+    return;
+  }
+
+  auto* hce = event->GetHCofThisEvent();
+  if (fHitsHCID < 0) {
+    fHitsHCID = G4SDManager::GetSDMpointer()->GetCollectionID(
+        G4String("gasSD/") + B3::GasSD::kHitsCollectionName);
+  }
+  auto* hits = (hce && fHitsHCID >= 0)
+    ? static_cast<B3::GasHitsCollection*>(hce->GetHC(fHitsHCID)) : nullptr;
+  Progress::AddEvent(hits ? G4long(hits->entries()) : 0);
+  if (hits) fRunAction->FillFromSteps(*hits);
+  Histograms::Fill(event, hits);
+  if (fHasPE) {
+    ModulationCurve::Fill(fPhotonE, fPhotonDir, fElectronDir);
+    Convergence::AddPhotoelectron(fPhotonE, fPhotonDir, fElectronDir);
+  }
+  Convergence::AddEvent(fWeightedEdepGas*MeV, fWeighted);
+
+  // sparse pixel list of the readout plane (/B3/readout/)
+  if (B3::PixelReadoutScorer::GetSettings().enabled) {
+    if (fPixelsHCID < 0) fPixelsHCID = G4SDManager::GetSDMpointer()->GetCollectionID("gas/pixels");
+    auto* pixels = (hce && fPixelsHCID >= 0)
+      ? static_cast<G4THitsMap<G4double>*>(hce->GetHC(fPixelsHCID)) : nullptr;
+    if (pixels) fRunAction->FillPixels(event->GetEventID(), *pixels);
+  }
+
+  // memory of this event, then back to bounded buffers after an outlier
+  HitBuffer::EndOfEvent(event->GetEventID(), hits ? G4long(hits->entries()) : 0,
+                        BufferBytes(hits) + fRunAction->BufferBytes());
+  const G4bool released = fRunAction->ReleaseBuffers();
+  if (ReleaseMaps() || released) HitBuffer::AddRelease();
+
+  fRunAction->EndOfEvent(event->GetEventID());
+
+  // companion mode: this event is one library track (see ElectronTrackLibrary)
+  auto& library = B3::ElectronTrackLibrary::Instance();
+  if (library.IsRecording()) {
+    const auto* vtx = event->GetPrimaryVertex(0);
+    if (!vtx || !vtx->GetPrimary(0) || !hits) return;
+
+    const G4ThreeVector v0 = vtx->GetPosition();
+    B3::ElectronTrackLibrary::Track trk;
+    trk.energy = vtx->GetPrimary(0)->GetKineticEnergy();
+    trk.deposits.reserve(hits->entries());
+    for (const auto* hp : *hits->GetVector()) {
+      const auto& h = *hp;
+      B3::ElectronTrackLibrary::Deposit d;
+      d.x  = G4float(h.x - v0.x()/mm);
+      d.y  = G4float(h.y - v0.y()/mm);
+      d.z  = G4float(h.z - v0.z()/mm);
+      d.t  = G4float(h.t - vtx->GetT0()/ns);
+      d.px = G4float(h.px); d.py = G4float(h.py); d.pz = G4float(h.pz);
+      d.edep    = G4float(h.edep);
+      d.stepLen = G4float(h.stepLen);
+      d.pdg         = h.pdg;
+      d.stepType    = h.stepType;
+      d.stepSubType = h.stepSubType;
+      trk.deposits.push_back(d);
+    }
+    library.AddTrack(std::move(trk));
+  }
+}
+
+G4double EventAction::BufferBytes(const B3::GasHitsCollection* hits) const
+{
+  // node: key, value and next pointer (libstdc++ caches no hash for int)
+  constexpr std::size_t node = sizeof(std::pair<const int,int>) + sizeof(void*);
+  G4double bytes = 0.;
+  for (const auto* map : {&fPrimaryOfTrack, &fGenerationOfTrack}) {
+    bytes += map->bucket_count() * sizeof(void*) + map->size() * node;
+  }
+  if (hits) {
+    bytes += hits->entries() * sizeof(B3::GasHit)
+           + hits->GetVector()->capacity() * sizeof(B3::GasHit*);
+  }
+  return bytes;
+}
+
+G4bool EventAction::ReleaseMaps()
+{
+  const std::size_t keep = std::size_t(HitBuffer::GetKeepCapacity());
+  if (fPrimaryOfTrack.bucket_count() <= keep && fGenerationOfTrack.bucket_count() <= keep) {
+    return false;
+  }
+  std::unordered_map<int,int>().swap(fPrimaryOfTrack);
+  std::unordered_map<int,int>().swap(fGenerationOfTrack);
+  return true;
+}
 
-void EventAction::EndOfEventAction(const G4Event*)
+void EventAction::ResolveAncestry(G4int trackID, G4int parentID,
+                                  G4int& rootID, G4int& generation)
 {
-  fRunAction->FillFromSteps(fSteps);
+  auto& primMap = fPrimaryOfTrack;
+  auto& genMap  = fGenerationOfTrack;
+  if (primMap.find(trackID) == primMap.end()) {
+    if (parentID == 0) {
+      primMap[trackID] = trackID;
+      genMap[trackID]  = 0;
+    } else {
+      auto itP = primMap.find(parentID);
+      primMap[trackID] = (itP != primMap.end()) ? itP->second : parentID;
+      auto itG = genMap.find(parentID);
+      genMap[trackID]  = (itG != genMap.end()) ? (itG->second + 1) : 1;
+    }
+  }
+  rootID     = primMap[trackID];
+  generation = genMap[trackID];
 }
 
 } // namespace B3a
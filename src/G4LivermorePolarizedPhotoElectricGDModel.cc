@@ -4,10 +4,15 @@
 #include "G4Electron.hh"
 #include "G4DynamicParticle.hh"
 #include "G4MaterialCutsCouple.hh"
+#include "G4LivermorePhotoElectricModel.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Log.hh"
 #include "Randomize.hh"
 
+#include <algorithm>
+#include <cmath>
+
 G4LivermorePolarizedPhotoElectricGDModel::
 G4LivermorePolarizedPhotoElectricGDModel(const G4String& name)
   : G4VEmModel(name)
@@ -15,17 +20,185 @@ G4LivermorePolarizedPhotoElectricGDModel(const G4String& name)
   // energy limits if you want them, not strictly needed
   SetLowEnergyLimit(10*eV);
   SetHighEnergyLimit(100*GeV);
+
+  fXSModel = new G4LivermorePhotoElectricModel();
 }
 
 void G4LivermorePolarizedPhotoElectricGDModel::Initialise(
     const G4ParticleDefinition* part,
-    const G4DataVector&)
+    const G4DataVector& cuts)
 {
   // we only care about gammas
   if (part == G4Gamma::Gamma()) {
     // this is the correct API for recent Geant4
     fParticleChange = GetParticleChangeForGamma();
   }
+
+  // the Livermore model loads its data on the master only
+  fXSModel->SetMasterThread(IsMaster());
+  fXSModel->Initialise(part, cuts);
+
+  if (fCosTheta.empty()) BuildAngularTables();
+}
+
+G4double G4LivermorePolarizedPhotoElectricGDModel::ComputeCrossSectionPerAtom(
+    const G4ParticleDefinition* part, G4double energy,
+    G4double Z, G4double A, G4double cut, G4double emax)
+{
+  return fXSModel->ComputeCrossSectionPerAtom(part, energy, Z, A, cut, emax);
+}
+
+G4double G4LivermorePolarizedPhotoElectricGDModel::CrossSectionPerVolume(
+    const G4Material* mat, const G4ParticleDefinition* part,
+    G4double energy, G4double cut, G4double emax)
+{
+  return fXSModel->CrossSectionPerVolume(mat, part, energy, cut, emax);
+}
+
+// --------------------------------------------------
+// GD angular density (same expression the old rejection loop used):
+//
+//   f(c,phi) = sin^2 / (1-bc)^4 * ( k^2/4 (1-bc) + (1/E - k^2 (1-bc)) cos^2 phi )
+//
+// with c = cos(theta). For fixed c the phi part is A cos^2 + B sin^2,
+// A = k^2/4 (1-bc) + (1/E - k^2 (1-bc)), B = k^2/4 (1-bc).
+// Negative weights are clamped to zero, as the old "num > 0" test did.
+// --------------------------------------------------
+void G4LivermorePolarizedPhotoElectricGDModel::PhiWeights(
+    G4double k, G4double cosTheta, G4double& wCos2, G4double& wSin2)
+{
+  const G4double eTot = k + electron_mass_c2;
+  const G4double beta = k / eTot;
+  const G4double oneMinusBcos = 1. - beta*cosTheta;
+
+  const G4double a = 0.25*k*k*oneMinusBcos;
+  const G4double b = (1./eTot) - k*k*oneMinusBcos;
+
+  wCos2 = std::max(a + b, 0.);
+  wSin2 = std::max(a, 0.);
+}
+
+// --------------------------------------------------
+// One inverse CDF of cos(theta) per log-spaced photon energy.
+// The marginal is integrated on a grid uniform in x = ln(1 - b c),
+// which puts the points where the forward peak is at high b.
+//
+// The quantiles are spaced as q(s) = (1 - cos(pi s))/2, s = j/(N-1):
+// near c = +-1 the CDF goes like (1 -+ c)^2, so with this spacing
+// cos(theta) is close to linear in s and the interpolation stays exact
+// in the tails instead of smearing them flat.
+// --------------------------------------------------
+namespace {
+inline G4double QuantileAt(G4double s)
+{
+  return 0.5*(1. - std::cos(pi*s));
+}
+}
+
+void G4LivermorePolarizedPhotoElectricGDModel::BuildAngularTables()
+{
+  const G4double emin = LowEnergyLimit();
+  const G4double emax = HighEnergyLimit();
+
+  fLogEmin = G4Log(emin);
+  const G4double decades = std::log10(emax/emin);
+  fNEnergies = std::max(2, G4int(decades*kBinsPerDecade) + 1);
+  const G4double dLogE = (G4Log(emax) - fLogEmin) / (fNEnergies - 1);
+  fInvDLogE = 1. / dLogE;
+
+  fCosTheta.assign(std::size_t(fNEnergies) * kNQuantiles, 0.);
+  std::vector<G4double> cdf(kNIntegrate, 0.);
+
+  for (G4int iE = 0; iE < fNEnergies; ++iE) {
+    const G4double k    = std::exp(fLogEmin + iE*dLogE);
+    const G4double beta = k / (k + electron_mass_c2);
+
+    // x runs from c = +1 (xlo) to c = -1 (xhi)
+    const G4double xlo = std::log1p(-beta);
+    const G4double xhi = std::log1p( beta);
+    const G4double dx  = (xhi - xlo) / (kNIntegrate - 1);
+
+    auto cosAt = [&](G4double x) {
+      return std::clamp(-std::expm1(x) / beta, -1., 1.);
+    };
+
+    // density in x is f(c) * |dc/dx| = f(c) * (1-bc)/b; the 1/b is dropped
+    auto densityAt = [&](G4double x) {
+      const G4double c   = cosAt(x);
+      const G4double omb = 1. - beta*c;
+      G4double wC, wS;
+      PhiWeights(k, c, wC, wS);
+      return (1. - c*c) / (omb*omb*omb) * (wC + wS);
+    };
+
+    G4double prev = densityAt(xlo);
+    cdf[0] = 0.;
+    for (G4int i = 1; i < kNIntegrate; ++i) {
+      const G4double cur = densityAt(xlo + i*dx);
+      cdf[i] = cdf[i-1] + 0.5*(prev + cur)*dx;
+      prev   = cur;
+    }
+    const G4double total = cdf[kNIntegrate - 1];
+
+    G4double* row = &fCosTheta[std::size_t(iE) * kNQuantiles];
+    if (!(total > 0.)) {
+      // nothing left after clamping: fall back to isotropic
+      for (G4int j = 0; j < kNQuantiles; ++j) {
+        row[j] = 1. - 2.*QuantileAt(G4double(j) / (kNQuantiles - 1));
+      }
+      continue;
+    }
+
+    G4int i = 0;
+    for (G4int j = 0; j < kNQuantiles; ++j) {
+      const G4double target = total * QuantileAt(G4double(j) / (kNQuantiles - 1));
+      while (i < kNIntegrate - 2 && cdf[i+1] < target) ++i;
+      const G4double span = cdf[i+1] - cdf[i];
+      const G4double t    = (span > 0.) ? std::clamp((target - cdf[i]) / span, 0., 1.) : 0.;
+      row[j] = cosAt(xlo + (i + t)*dx);
+    }
+  }
+}
+
+void G4LivermorePolarizedPhotoElectricGDModel::SampleAngles(
+    G4double k,
+    G4double& cosTheta, G4double& sinTheta,
+    G4double& cosPhi,   G4double& sinPhi) const
+{
+  // ---- theta: pick one of the two neighbouring energy rows ----
+  G4double lx = (G4Log(k) - fLogEmin) * fInvDLogE;
+  lx = std::clamp(lx, 0., G4double(fNEnergies - 1));
+  G4int iE = G4int(lx);
+  if (iE < fNEnergies - 1 && G4UniformRand() < lx - iE) ++iE;
+
+  // invert q = (1 - cos(pi s))/2 to land on the table index s
+  const G4double* row = &fCosTheta[std::size_t(iE) * kNQuantiles];
+  const G4double q = std::acos(1. - 2.*G4UniformRand()) / pi * (kNQuantiles - 1);
+  const G4int    j = std::min(G4int(q), kNQuantiles - 2);
+  cosTheta = row[j] + (q - j)*(row[j+1] - row[j]);
+  sinTheta = std::sqrt(std::max(0., (1. - cosTheta)*(1. + cosTheta)));
+
+  // ---- phi: A cos^2 + B sin^2 = min(A,B) + |A-B| (cos^2 or sin^2) ----
+  G4double wC, wS;
+  PhiWeights(k, cosTheta, wC, wS);
+  const G4double wFlat  = 2.*std::min(wC, wS);   // integral 2pi*min
+  const G4double wPeak  = std::abs(wC - wS);     // integral  pi*|A-B|
+
+  if (wFlat + wPeak <= 0. || G4UniformRand()*(wFlat + wPeak) < wFlat) {
+    const G4double phi = twopi*G4UniformRand();
+    cosPhi = std::cos(phi);
+    sinPhi = std::sin(phi);
+    return;
+  }
+
+  // cos^2 density: sin(phi) follows the semicircle law, i.e. the
+  // x coordinate of a point uniform in the unit disk
+  const G4double s = std::sqrt(G4UniformRand()) * std::cos(twopi*G4UniformRand());
+  G4double c = std::sqrt(std::max(0., 1. - s*s));
+  if (G4UniformRand() < 0.5) c = -c;
+
+  if (wC >= wS) { sinPhi = s; cosPhi = c; }
+  else          { cosPhi = s; sinPhi = c; }
 }
 
 void G4LivermorePolarizedPhotoElectricGDModel::SampleSecondaries(
@@ -51,32 +224,25 @@ void G4LivermorePolarizedPhotoElectricGDModel::SampleSecondaries(
   // photon direction
   const G4ThreeVector photonDir = aDynamicGamma->GetMomentumDirection();
 
-  // ---- GD-like angular sampling (simplified, from your attempt) ----
-  G4double theta, phi;
-  const G4double beta = elecE / (elecE + electron_mass_c2);
-  const G4double eTot = elecE + electron_mass_c2;
-
-  while (true) {
-    const G4double u = G4UniformRand();
-    theta = std::acos(1. - 2.*u);
-    phi   = twopi * G4UniformRand();
-
-    const G4double oneMinusBcos = 1. - beta*std::cos(theta);
-    const G4double sin2t = std::sin(theta)*std::sin(theta);
-    const G4double cos2p = std::cos(phi)*std::cos(phi);
-
-    const G4double num =
-      sin2t / std::pow(oneMinusBcos, 4) *
-      ( 0.25*k*k*oneMinusBcos + ((1./eTot) - k*k*oneMinusBcos)*cos2p );
-
-    if (num > 0. && G4UniformRand() < num) break;
+  // ---- GD-like angular sampling (table for theta, closed form for phi) ----
+  G4double cosT, sinT, cosP, sinP;
+  SampleAngles(k, cosT, sinT, cosP, sinP);
+
+  // photon frame: phi is measured from the linear polarization;
+  // unpolarized photons get a random azimuth for that axis
+  G4ThreeVector xAxis = aDynamicGamma->GetPolarization();
+  xAxis -= xAxis.dot(photonDir) * photonDir;
+  if (xAxis.mag2() > 1e-12) {
+    xAxis = xAxis.unit();
+  } else {
+    const G4ThreeVector ox = photonDir.orthogonal().unit();
+    const G4ThreeVector oy = photonDir.cross(ox);
+    const G4double psi = twopi*G4UniformRand();
+    xAxis = std::cos(psi)*ox + std::sin(psi)*oy;
   }
+  const G4ThreeVector yAxis = photonDir.cross(xAxis);
 
-  // electron direction in photon frame
-  G4ThreeVector eDir(std::sin(theta)*std::cos(phi),
-                     std::sin(theta)*std::sin(phi),
-                     std::cos(theta));
-  eDir.rotateUz(photonDir);
+  const G4ThreeVector eDir = sinT*cosP*xAxis + sinT*sinP*yAxis + cosT*photonDir;
 
   auto* electron = new G4DynamicParticle(G4Electron::Electron(), eDir, elecE);
   fvect->push_back(electron);
@@ -0,0 +1,186 @@
+/// \file B3/B3a/src/GasSD.cc
+/// \brief Implementation of the B3::GasSD class
+
+#include "GasSD.hh"
+#include "EventAction.hh"
+#include "AdjointFlux.hh"
+
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+
+namespace B3 {
+
+G4ThreadLocal G4Allocator<GasHit>* GasHitAllocator = nullptr;
+
+GasSD::GasSD(const G4String& name)
+  : G4VSensitiveDetector(name)
+{
+  collectionName.insert(kHitsCollectionName);
+}
+
+void GasSD::Initialize(G4HCofThisEvent* HCE)
+{
+  fHitsCollection = new GasHitsCollection(SensitiveDetectorName, collectionName[0]);
+  if (fHCID < 0) fHCID = G4SDManager::GetSDMpointer()->GetCollectionID(fHitsCollection);
+  HCE->AddHitsCollection(fHCID, fHitsCollection);
+
+  fEventAction = dynamic_cast<B3a::EventAction*>(
+      G4EventManager::GetEventManager()->GetUserEventAction());
+}
+
+void GasSD::AddHit(const GasHit& hit)
+{
+  if (!fEventAction) return;
+  fEventAction->AddToTotalEdepGas(hit.edep, hit.weight);
+  if (fEventAction->KeepSteps()) fHitsCollection->insert(new GasHit(hit));
+}
+
+G4bool GasSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{
+  if (!fEventAction) return false;
+  const auto edep = step->GetTotalEnergyDeposit();
+
+  auto* trk  = step->GetTrack();
+  auto* pre  = step->GetPreStepPoint();
+  auto* post = step->GetPostStepPoint();
+  const auto* sp = post ? post->GetProcessDefinedStep() : nullptr;
+
+  // ======================================================
+  // STRICT primary-gamma photoelectric capture
+  // ======================================================
+  // before the edep and pixel-only cuts: the modulation curve needs it
+  // also when the absorption step deposits nothing or no step is kept
+  G4int nEle = 0;
+  const G4Track* pe = nullptr;
+  if (sp &&
+      sp->GetProcessType() == 2 &&          // EM
+      sp->GetProcessSubType() == 12 &&      // photoelectric
+      trk->GetDefinition()->GetPDGEncoding() == 22 &&
+      trk->GetParentID() == 0)              // primary gamma
+  {
+    pe = FindPhotoelectron(step, sp, nEle);
+    if (pe) {
+      fEventAction->SetPhotoelectron(pre->GetKineticEnergy(), pre->GetMomentumDirection(),
+                                     pe->GetMomentumDirection());
+    }
+  }
+
+  if (edep <= 0.) return false;
+
+  // adjoint run: only the forward particles deposit in the gas
+  if (B3a::AdjointFlux::IsEnabled()
+      && trk->GetDefinition()->GetParticleName().compare(0, 4, "adj_") == 0) return false;
+
+  // pixel lists only: the readout scorer has the deposit already
+  if (!fEventAction->KeepSteps()) {
+    fEventAction->AddToTotalEdepGas(edep/MeV, trk->GetWeight());
+    return true;
+  }
+
+  auto* h = new GasHit();
+
+  // ----- standard fill -----
+  h->eventID  = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+  h->trackID  = trk->GetTrackID();
+  h->parentID = trk->GetParentID();
+  h->pdg      = trk->GetDefinition()->GetPDGEncoding();
+
+  // ancestry
+  fEventAction->ResolveAncestry(h->trackID, h->parentID, h->rootID, h->generation);
+
+  const auto pos = pre->GetPosition();
+  h->x = pos.x()/mm; h->y = pos.y()/mm; h->z = pos.z()/mm;
+  h->t = pre->GetGlobalTime()/ns;
+
+  const auto mom = pre->GetMomentum();
+  h->px = mom.x(); h->py = mom.y(); h->pz = mom.z();
+
+  h->edep    = edep/MeV;
+  h->stepLen = step->GetStepLength()/mm;
+  h->weight  = trk->GetWeight();
+
+  const auto* cp = trk->GetCreatorProcess();
+  h->creatorType    = cp ? cp->GetProcessType()    : -1;
+  h->creatorSubType = cp ? cp->GetProcessSubType() : -1;
+
+  h->stepType      = sp ? sp->GetProcessType()    : -1;
+  h->stepSubType   = sp ? sp->GetProcessSubType() : -1;
+
+  if (pe) {
+    const auto eMom = pe->GetMomentum();   // MeV/c
+    const double epx = eMom.x();
+    const double epy = eMom.y();
+    const double epz = eMom.z();
+
+    // angles
+    double theta = 0.0, phi = 0.0;
+    const double p = std::sqrt(epx*epx + epy*epy + epz*epz);
+    if (p > 0.) {
+      theta = std::acos(epz / p);
+      phi   = std::atan2(epy, epx);
+      if (phi < 0.) phi += 2.0*M_PI;
+    }
+
+    h->isPE      = 1;
+    h->peTrackID = pe->GetTrackID();
+    h->pePx      = epx;
+    h->pePy      = epy;
+    h->pePz      = epz;
+    h->peEkin    = pe->GetKineticEnergy() / MeV;
+    h->peTheta   = theta;
+    h->pePhi     = phi;
+    h->nPEsec    = nEle;   // total electrons we saw in this PE step
+  }
+
+  fHitsCollection->insert(h);
+  fEventAction->AddToTotalEdepGas(h->edep, h->weight);
+  return true;
+}
+
+const G4Track* GasSD::FindPhotoelectron(const G4Step* step, const G4VProcess* sp, G4int& nEle)
+{
+  const auto& secs = *(step->GetSecondaryInCurrentStep());
+
+  // 1) try to find the electron CREATED BY THIS VERY PROCESS (sp)
+  const G4Track* chosenEle = nullptr;
+  nEle = 0;
+
+  // also keep a fallback = highest-KE e-
+  const G4Track* fallbackEle = nullptr;
+  double fallbackKE = -1.0; // MeV
+
+  for (const auto* s : secs) {
+    if (!s) continue;
+    const auto* def = s->GetDefinition();
+    if (!def) continue;
+    if (def->GetPDGEncoding() != 11) continue; // only electrons
+    ++nEle;
+
+    // is this electron produced by the SAME process as the step?
+    if (s->GetCreatorProcess() == sp) {
+      // this is the real photoelectron we wanted
+      chosenEle = s;
+      break;  // we can stop
+    }
+
+    // otherwise, update fallback (highest KE)
+    const double ke = s->GetKineticEnergy() / MeV;
+    if (ke > fallbackKE) {
+      fallbackKE  = ke;
+      fallbackEle = s;
+    }
+  }
+
+  // 2) decide which one to use
+  return chosenEle ? chosenEle : fallbackEle;
+}
+
+} // namespace B3
@@ -0,0 +1,107 @@
+/// \file B3/B3a/src/HistogramMessenger.cc
+/// \brief Implementation of the B3a::HistogramMessenger class
+
+#include "HistogramMessenger.hh"
+#include "Histograms.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+
+#include <sstream>
+
+namespace B3a {
+
+namespace {
+void AddAxis(G4UIcommand* cmd, const G4String& axis)
+{
+  cmd->SetParameter(new G4UIparameter(("q" + axis).c_str(), 's', false));
+  auto* n = new G4UIparameter(("n" + axis).c_str(), 'i', false);
+  n->SetParameterRange(("n" + axis + " > 0").c_str());
+  cmd->SetParameter(n);
+  cmd->SetParameter(new G4UIparameter((axis + "min").c_str(), 'd', false));
+  cmd->SetParameter(new G4UIparameter((axis + "max").c_str(), 'd', false));
+}
+}
+
+HistogramMessenger::HistogramMessenger()
+{
+  fDir = new G4UIdirectory("/B3/histo/");
+  fDir->SetGuidance("Online histograms, filled at the end of each event");
+  fDir->SetGuidance("Quantities: edep, edep:<particle> [keV], primaryE [keV],");
+  fDir->SetGuidance("radius, z [mm] (edep-weighted means), nHits");
+
+  fH1Cmd = new G4UIcommand("/B3/histo/h1", this);
+  fH1Cmd->SetGuidance("Add an H1 of an event quantity: quantity nbins min max");
+  AddAxis(fH1Cmd, "x");
+  fH1Cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fH1Cmd->SetToBeBroadcasted(false);
+
+  fH2Cmd = new G4UIcommand("/B3/histo/h2", this);
+  fH2Cmd->SetGuidance("Add an H2: qx nx xmin xmax qy ny ymin ymax");
+  AddAxis(fH2Cmd, "x");
+  AddAxis(fH2Cmd, "y");
+  fH2Cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fH2Cmd->SetToBeBroadcasted(false);
+
+  fOnlyCmd = new G4UIcmdWithABool("/B3/histo/only", this);
+  fOnlyCmd->SetGuidance("Write only the histograms (no 'steps' / 'pixels' trees)");
+  fOnlyCmd->SetParameterName("on", true);
+  fOnlyCmd->SetDefaultValue(true);
+  fOnlyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fOnlyCmd->SetToBeBroadcasted(false);
+
+  fFileCmd = new G4UIcmdWithAString("/B3/histo/fileName", this);
+  fFileCmd->SetGuidance("Histogram file name (default tpc_histos, .root is added)");
+  fFileCmd->SetParameterName("name", false);
+  fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fFileCmd->SetToBeBroadcasted(false);
+}
+
+HistogramMessenger::~HistogramMessenger()
+{
+  delete fH1Cmd;
+  delete fH2Cmd;
+  delete fOnlyCmd;
+  delete fFileCmd;
+  delete fDir;
+}
+
+void HistogramMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  if (cmd == fH1Cmd) {
+
+    std::istringstream is(value);
+    G4String q;
+    G4int n;
+    G4double min, max;
+    is >> q >> n >> min >> max;
+    if (!Histograms::AddH1(q, n, min, max)) {
+      G4cerr << "/B3/histo/h1: unknown quantity " << q << G4endl;
+    }
+
+  } else if (cmd == fH2Cmd) {
+
+    std::istringstream is(value);
+    G4String qx, qy;
+    G4int nx, ny;
+    G4double xmin, xmax, ymin, ymax;
+    is >> qx >> nx >> xmin >> xmax >> qy >> ny >> ymin >> ymax;
+    if (!Histograms::AddH2(qx, nx, xmin, xmax, qy, ny, ymin, ymax)) {
+      G4cerr << "/B3/histo/h2: unknown quantity " << qx << " or " << qy << G4endl;
+    }
+
+  } else if (cmd == fOnlyCmd) {
+
+    Histograms::SetOnly(fOnlyCmd->GetNewBoolValue(value));
+
+  } else if (cmd == fFileCmd) {
+
+    Histograms::SetFileName(value);
+
+  }
+}
+
+} // namespace B3a
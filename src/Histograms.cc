@@ -0,0 +1,151 @@
+/// \file B3/B3a/src/Histograms.cc
+/// \brief Implementation of the B3a::Histograms class
+
+#include "Histograms.hh"
+
+#include "G4AnalysisManager.hh"
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+
+namespace B3a {
+
+namespace {
+// histograms already created by this thread's analysis manager
+G4ThreadLocal std::size_t nCreated = 0;
+G4ThreadLocal G4bool      fileOpen = false;
+}
+
+G4bool Histograms::ParseQuantity(const G4String& text, Quantity& q)
+{
+  q = Quantity();
+  q.name = text;
+
+  const auto colon = text.find(':');
+  const G4String kind = text.substr(0, colon);
+
+  if      (kind == "edep")     q.kind = kEdep;
+  else if (kind == "primaryE") q.kind = kPrimaryE;
+  else if (kind == "radius")   q.kind = kRadius;
+  else if (kind == "z")        q.kind = kZ;
+  else if (kind == "nHits")    q.kind = kNHits;
+  else return false;
+
+  if (colon != G4String::npos) {
+    if (q.kind != kEdep) return false;
+    const auto* particle = G4ParticleTable::GetParticleTable()->FindParticle(text.substr(colon + 1));
+    if (!particle) return false;
+    q.pdg = particle->GetPDGEncoding();
+  }
+  return true;
+}
+
+G4bool Histograms::AddH1(const G4String& q, G4int n, G4double min, G4double max)
+{
+  Definition d;
+  if (!ParseQuantity(q, d.x)) return false;
+  d.nx = n; d.xmin = min; d.xmax = max;
+  fDefs.push_back(d);
+  return true;
+}
+
+G4bool Histograms::AddH2(const G4String& qx, G4int nx, G4double xmin, G4double xmax,
+                         const G4String& qy, G4int ny, G4double ymin, G4double ymax)
+{
+  Definition d;
+  if (!ParseQuantity(qx, d.x) || !ParseQuantity(qy, d.y)) return false;
+  d.is2D = true;
+  d.nx = nx; d.xmin = xmin; d.xmax = xmax;
+  d.ny = ny; d.ymin = ymin; d.ymax = ymax;
+  fDefs.push_back(d);
+  return true;
+}
+
+void Histograms::BeginOfRun(const std::string& dir)
+{
+  if (!HasAny()) return;
+
+  auto* analysis = G4AnalysisManager::Instance();
+  analysis->SetDefaultFileType("root");
+
+  // H1 and H2 ids are separate; keep one list, in definition order
+  for (; nCreated < fDefs.size(); ++nCreated) {
+    const auto& d = fDefs[nCreated];
+    if (d.is2D) {
+      analysis->CreateH2(d.x.name + "_vs_" + d.y.name, d.y.name + " vs " + d.x.name,
+                         d.nx, d.xmin, d.xmax, d.ny, d.ymin, d.ymax);
+    } else {
+      analysis->CreateH1(d.x.name, d.x.name, d.nx, d.xmin, d.xmax);
+    }
+  }
+
+  const std::string name = dir.empty() ? std::string(fFileName) : dir + "/" + fFileName;
+  fileOpen = analysis->OpenFile(name);
+}
+
+void Histograms::EndOfRun()
+{
+  if (!fileOpen) return;
+
+  // workers hand their histograms to the master, which writes the sum
+  auto* analysis = G4AnalysisManager::Instance();
+  analysis->Write();
+  analysis->CloseFile();
+  fileOpen = false;
+}
+
+G4double Histograms::Value(const Quantity& q, const G4Event* event,
+                           const B3::GasHitsCollection* hits)
+{
+  if (q.kind == kPrimaryE) {
+    const auto* vtx = event->GetPrimaryVertex(0);
+    return (vtx && vtx->GetPrimary(0)) ? vtx->GetPrimary(0)->GetKineticEnergy()/keV : 0.;
+  }
+  if (!hits) return 0.;
+
+  // every hit counts with its track weight (1 without importance biasing)
+  G4double sum = 0., sumR = 0., sumZ = 0., nHits = 0.;
+  for (const auto* h : *hits->GetVector()) {
+    nHits += h->weight;
+    if (q.pdg != 0 && h->pdg != q.pdg) continue;
+    const G4double e = h->edep * h->weight;
+    sum  += e;
+    sumR += e * std::sqrt(h->x*h->x + h->y*h->y);
+    sumZ += e * h->z;
+  }
+  switch (q.kind) {
+    case kNHits:  return nHits;
+    case kEdep:   return sum * 1000.;   // MeV -> keV
+    case kRadius: return (sum > 0.) ? sumR / sum : 0.;
+    case kZ:      return (sum > 0.) ? sumZ / sum : 0.;
+    default:      return 0.;
+  }
+}
+
+void Histograms::Fill(const G4Event* event, const B3::GasHitsCollection* hits)
+{
+  if (!fileOpen) return;
+
+  const G4bool inGas = hits && hits->entries() > 0;
+  auto* analysis = G4AnalysisManager::Instance();
+
+  G4int h1 = 0, h2 = 0;
+  for (const auto& d : fDefs) {
+    const G4int id = d.is2D ? h2++ : h1++;
+    const G4bool needsGas = d.x.NeedsGas() || (d.is2D && d.y.NeedsGas());
+    if (needsGas && !inGas) continue;
+
+    if (d.is2D) {
+      analysis->FillH2(id, Value(d.x, event, hits), Value(d.y, event, hits));
+    } else {
+      analysis->FillH1(id, Value(d.x, event, hits));
+    }
+  }
+}
+
+} // namespace B3a
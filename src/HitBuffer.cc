@@ -0,0 +1,175 @@
+/// \file B3/B3a/src/HitBuffer.cc
+/// \brief Implementation of the B3a::HitBuffer class
+
+#include "HitBuffer.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <string>
+
+namespace B3a {
+
+namespace {
+G4Mutex gBufferMutex = G4MUTEX_INITIALIZER;
+
+G4ThreadLocal HitBuffer::Counters* local = nullptr;
+
+// master: sums of the threads of the current run
+HitBuffer::Counters gMerged;
+std::size_t gThreads = 0;
+}
+
+G4int HitBuffer::Bin(G4long nHits)
+{
+  G4int bin = 0;
+  while (nHits > 0 && bin < kNBins - 1) { nHits >>= 1; ++bin; }
+  return bin;
+}
+
+void HitBuffer::BeginOfRun()
+{
+  if (G4Threading::IsMasterThread()) {
+    G4AutoLock lock(&gBufferMutex);
+    gMerged = Counters();
+    gThreads = 0;
+  }
+  if (!local) local = new Counters;
+  *local = Counters();
+}
+
+void HitBuffer::EndOfEvent(G4int eventID, G4long nHits, G4double bytes)
+{
+  if (!local) return;
+
+  auto& c = *local;
+  c.events += 1;
+  c.hits   += nHits;
+  c.histogram[Bin(nHits)] += 1;
+  if (nHits > c.peakHits) { c.peakHits = nHits; c.peakEvent = eventID; }
+  c.peakBytes = std::max(c.peakBytes, bytes);
+}
+
+void HitBuffer::AddSpill(G4long extraEntries)
+{
+  if (!local) return;
+  local->spilled      += 1;
+  local->extraEntries += extraEntries;
+}
+
+void HitBuffer::AddCoarsened(G4long hitsIn, G4long hitsOut)
+{
+  if (!local) return;
+  local->coarsened += 1;
+  local->hitsIn    += hitsIn;
+  local->hitsOut   += hitsOut;
+}
+
+void HitBuffer::AddRelease()
+{
+  if (local) local->released += 1;
+}
+
+void HitBuffer::Coarsen(const std::vector<B3::GasHit*>& hits, G4long maxHits,
+                        std::vector<B3::GasHit>& out)
+{
+  out.clear();
+  if (hits.empty() || maxHits <= 0) return;
+
+  // steps per merged hit
+  const std::size_t group = (hits.size() + maxHits - 1) / maxHits;
+  out.reserve(hits.size() / group + 1);
+
+  std::size_t i = 0;
+  while (i < hits.size()) {
+    const auto& first = *hits[i];
+    B3::GasHit merged = first;
+    std::size_t n = 1;
+    if (!first.isPE) {
+      G4double e = first.edep;
+      G4double x = first.x * e, y = first.y * e, z = first.z * e;
+      while (n < group && i + n < hits.size()) {
+        const auto& h = *hits[i + n];
+        if (h.trackID != first.trackID || h.isPE) break;
+        e += h.edep;
+        x += h.x * h.edep; y += h.y * h.edep; z += h.z * h.edep;
+        merged.stepLen += h.stepLen;
+        merged.stepType    = h.stepType;     // the process that ended the segment
+        merged.stepSubType = h.stepSubType;
+        ++n;
+      }
+      merged.edep = e;
+      if (e > 0.) { merged.x = x / e; merged.y = y / e; merged.z = z / e; }
+    }
+    out.push_back(merged);
+    i += n;
+  }
+}
+
+void HitBuffer::EndOfRun(G4int runID)
+{
+  if (!local) return;
+
+  {
+    G4AutoLock lock(&gBufferMutex);
+    const auto& c = *local;
+    gMerged.events       += c.events;
+    gMerged.hits         += c.hits;
+    gMerged.spilled      += c.spilled;
+    gMerged.extraEntries += c.extraEntries;
+    gMerged.coarsened    += c.coarsened;
+    gMerged.hitsIn       += c.hitsIn;
+    gMerged.hitsOut      += c.hitsOut;
+    gMerged.released     += c.released;
+    for (G4int b = 0; b < kNBins; ++b) gMerged.histogram[b] += c.histogram[b];
+    if (c.peakHits > gMerged.peakHits) {
+      gMerged.peakHits  = c.peakHits;
+      gMerged.peakEvent = c.peakEvent;
+    }
+    gMerged.peakBytes = std::max(gMerged.peakBytes, c.peakBytes);
+    if (c.events > 0) ++gThreads;
+  }
+  if (!G4Threading::IsMasterThread() || gMerged.events == 0) return;
+
+  if (fReport) {
+    Print(gMerged, runID, gThreads);
+  } else if (gMerged.spilled > 0 || gMerged.coarsened > 0) {
+    G4cout << "---- Hit buffers (run " << runID << "): " << gMerged.spilled
+           << " event(s) spilled, " << gMerged.coarsened << " coarsened above "
+           << fMaxHits << " hits; peak " << gMerged.peakHits << " hits (event "
+           << gMerged.peakEvent << ") ----" << G4endl;
+  }
+}
+
+void HitBuffer::Print(const Counters& c, G4int runID, std::size_t nThreads)
+{
+  G4cout << "\n---- Hits and buffers (run " << runID << ") ----\n"
+         << "  events written      " << c.events << ", "
+         << G4double(c.hits) / c.events << " hits/event\n"
+         << "  peak hits/event     " << c.peakHits << " (event " << c.peakEvent << ")\n"
+         << "  peak buffer memory  " << std::fixed << std::setprecision(1)
+         << c.peakBytes / (1024. * 1024.) << " MB per thread (largest of "
+         << nThreads << " thread(s))\n" << std::defaultfloat << std::setprecision(6);
+  if (fMaxHits > 0) {
+    G4cout << "  limit " << fMaxHits << " hits: " << c.spilled << " event(s) spilled into "
+           << c.extraEntries << " extra entries, " << c.coarsened << " coarsened ("
+           << c.hitsIn << " -> " << c.hitsOut << " hits)\n";
+  }
+  G4cout << "  buffers released    " << c.released << " time(s) (above "
+         << fKeepCapacity << ")\n"
+         << "  hits/event          events" << G4endl;
+  for (G4int b = 0; b < kNBins; ++b) {
+    if (c.histogram[b] == 0) continue;
+    const G4long lo = b == 0 ? 0 : (1L << (b - 1));
+    std::string range = std::to_string(lo);
+    if (b == kNBins - 1) range += " and more";
+    else if (b > 1)      range += " - " + std::to_string((1L << b) - 1);
+    G4cout << "  " << std::left << std::setw(20) << range << std::right
+           << std::setw(10) << c.histogram[b] << G4endl;
+  }
+  G4cout << "--------------------------------------" << G4endl;
+}
+
+} // namespace B3a
@@ -0,0 +1,144 @@
+/// \file B3/B3a/src/ImportanceWorld.cc
+/// \brief Implementation of the B3::ImportanceWorld class
+
+#include "ImportanceWorld.hh"
+#include "ImportanceWorldMessenger.hh"
+
+#include "G4Sphere.hh"
+#include "G4Tubs.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PVPlacement.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4IStore.hh"
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4Exception.hh"
+
+#include <cmath>
+
+namespace B3 {
+
+ImportanceWorld::ImportanceWorld()
+  : G4VUserParallelWorld(kWorldName)
+{
+  fMessenger = new ImportanceWorldMessenger(this);
+}
+
+ImportanceWorld::~ImportanceWorld()
+{
+  delete fMessenger;
+}
+
+void ImportanceWorld::SetShells(G4int n, G4double rmin, G4double rmax)
+{
+  fNShells = n;
+  fRmin    = rmin;
+  fRmax    = rmax;
+  if (!fShells.empty()) G4RunManager::GetRunManager()->ReinitializeGeometry();
+}
+
+void ImportanceWorld::SetRatio(G4double ratio)
+{
+  fRatio = ratio;
+  // the importance store is refilled with the geometry
+  if (!fShells.empty()) G4RunManager::GetRunManager()->ReinitializeGeometry();
+}
+
+void ImportanceWorld::Construct()
+{
+  auto* ghostLV = GetWorld()->GetLogicalVolume();
+
+  // Called again after /B3/det/ or /B3/bias/ changes (ReinitializeGeometry):
+  // same number of shells, the spheres are resized and moved; otherwise the
+  // old shells are taken out of the world (not deleted: the navigators may
+  // still point to them) and new ones built. ConstructSD refills the store.
+  std::vector<G4double> radii;
+  G4ThreeVector centre;
+  if (!Radii(radii, centre) || radii.size() != fShells.size()) {
+    if (!fShells.empty()) ghostLV->RemoveDaughter(fShells.front());
+    fShells.clear();
+  }
+  if (radii.empty()) return;
+
+  if (!fShells.empty()) {
+    fShells.front()->SetTranslation(centre);
+    for (std::size_t k = 0; k < fShells.size(); ++k) {
+      static_cast<G4Sphere*>(fShells[k]->GetLogicalVolume()->GetSolid())->SetOuterRadius(radii[k]);
+    }
+    return;
+  }
+
+  auto* mother = ghostLV;
+  G4ThreeVector pos = centre;
+  for (std::size_t k = 0; k < radii.size(); ++k) {
+    const G4String name = "ImpShell_" + std::to_string(k);
+    auto* solid = new G4Sphere(name, 0., radii[k], 0., twopi, 0., pi);
+    auto* lv    = new G4LogicalVolume(solid, nullptr, name);
+    fShells.push_back(new G4PVPlacement(nullptr, pos, lv, name, mother, false, G4int(k), false));
+
+    mother = lv;
+    pos    = G4ThreeVector();   // the next one is centred in this one
+  }
+}
+
+G4bool ImportanceWorld::Radii(std::vector<G4double>& radii, G4ThreeVector& centre) const
+{
+  radii.clear();
+  if (fNShells <= 0) return false;
+
+  // centred on the gas cylinder (built just before in the mass world)
+  const auto* gasPV =
+    G4PhysicalVolumeStore::GetInstance()->GetVolume("TPCGas", false);
+  if (!gasPV) {
+    G4Exception("ImportanceWorld::Construct", "B3Bias001", JustWarning,
+                "No TPCGas volume: no importance shells.");
+    return false;
+  }
+  centre = gasPV->GetTranslation();
+
+  G4double rmin = fRmin;
+  if (rmin <= 0.) {
+    const auto* tubs = dynamic_cast<const G4Tubs*>(gasPV->GetLogicalVolume()->GetSolid());
+    const G4double r  = tubs ? tubs->GetOuterRadius()   : 0.;
+    const G4double dz = tubs ? tubs->GetZHalfLength()   : 0.;
+    rmin = std::sqrt(r*r + dz*dz) + 1.*mm;
+  }
+  if (rmin >= fRmax) {
+    G4Exception("ImportanceWorld::Construct", "B3Bias002", JustWarning,
+                "Inner shell radius >= outer one: no importance shells.");
+    return false;
+  }
+
+  for (G4int k = 0; k < fNShells; ++k) {
+    radii.push_back((fNShells == 1)
+      ? fRmax
+      : fRmax * std::pow(rmin/fRmax, G4double(k)/(fNShells - 1)));
+  }
+  return true;
+}
+
+void ImportanceWorld::ConstructSD()
+{
+  // the importance store is thread local; this runs on every thread
+  auto* istore = G4IStore::GetInstance(GetName());
+  istore->Clear();
+  istore->AddImportanceGeometryCell(1., *GetWorld(), 0);
+
+  G4double importance = 1.;
+  for (const auto* pv : fShells) {
+    importance *= fRatio;
+    istore->AddImportanceGeometryCell(importance, *pv, pv->GetCopyNo());
+  }
+}
+
+void ImportanceWorld::Print() const
+{
+  G4cout << "---- Importance shells (" << GetName() << ") ----\n"
+         << "  shells : " << fNShells << ", ratio " << fRatio << "\n";
+  if (fRmin > 0.) G4cout << "  rmin   : " << G4BestUnit(fRmin, "Length") << "\n";
+  else            G4cout << "  rmin   : gas bounding sphere + 1 mm\n";
+  G4cout << "  rmax   : " << G4BestUnit(fRmax, "Length") << G4endl;
+}
+
+} // namespace B3
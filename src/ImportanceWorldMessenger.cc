@@ -0,0 +1,81 @@
+/// \file B3/B3a/src/ImportanceWorldMessenger.cc
+
+#include "ImportanceWorldMessenger.hh"
+#include "ImportanceWorld.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+namespace B3 {
+
+ImportanceWorldMessenger::ImportanceWorldMessenger(ImportanceWorld* world)
+  : fWorld(world)
+{
+  fDir = new G4UIdirectory("/B3/bias/");
+  fDir->SetGuidance("Importance shells around the TPC");
+
+  fShellsCmd = new G4UIcommand("/B3/bias/shells", this);
+  fShellsCmd->SetGuidance("Concentric spheres around the gas: shells <n> <rmin> <rmax> <unit>");
+  fShellsCmd->SetGuidance("radii in geometric progression; rmin <= 0: just outside the gas");
+  auto* pN    = new G4UIparameter("n", 'i', false);
+  pN->SetParameterRange("n >= 0");
+  auto* pMin  = new G4UIparameter("rmin", 'd', false);
+  auto* pMax  = new G4UIparameter("rmax", 'd', false);
+  auto* pUnit = new G4UIparameter("unit", 's', true);
+  pUnit->SetDefaultValue("cm");
+  fShellsCmd->SetParameter(pN);
+  fShellsCmd->SetParameter(pMin);
+  fShellsCmd->SetParameter(pMax);
+  fShellsCmd->SetParameter(pUnit);
+  fShellsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fShellsCmd->SetToBeBroadcasted(false);
+
+  fRatioCmd = new G4UIcmdWithADouble("/B3/bias/ratio", this);
+  fRatioCmd->SetGuidance("Importance ratio between neighbouring shells (split factor)");
+  fRatioCmd->SetParameterName("ratio", false);
+  fRatioCmd->SetRange("ratio >= 1.");
+  fRatioCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRatioCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/B3/bias/print", this);
+  fPrintCmd->SetGuidance("Print the importance shells");
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+ImportanceWorldMessenger::~ImportanceWorldMessenger()
+{
+  delete fShellsCmd;
+  delete fRatioCmd;
+  delete fPrintCmd;
+  delete fDir;
+}
+
+void ImportanceWorldMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  if (cmd == fShellsCmd) {
+
+    std::istringstream is(value);
+    G4int n;
+    G4double rmin, rmax;
+    G4String unit;
+    is >> n >> rmin >> rmax >> unit;
+    const G4double u = G4UIcommand::ValueOf(unit);
+    fWorld->SetShells(n, rmin*u, rmax*u);
+
+  } else if (cmd == fRatioCmd) {
+
+    fWorld->SetRatio(fRatioCmd->GetNewDoubleValue(value));
+
+  } else if (cmd == fPrintCmd) {
+
+    fWorld->Print();
+
+  }
+}
+
+} // namespace B3
@@ -0,0 +1,198 @@
+/// \file B3/B3a/src/ModulationCurve.cc
+/// \brief Implementation of the B3a::ModulationCurve class
+
+#include "ModulationCurve.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Threading.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace B3a {
+
+namespace {
+G4Mutex gMergeMutex = G4MUTEX_INITIALIZER;
+
+// this thread's histograms, [energy bin * nPhi + phi bin]
+G4ThreadLocal std::vector<G4long>* localCounts = nullptr;
+G4ThreadLocal G4bool               localActive = false;
+
+// polarization axis of PrimaryGeneratorAction
+const G4ThreeVector kPolarizationAxis(0., 1., 0.);
+}
+
+void ModulationCurve::BeginOfRun(G4bool polarized)
+{
+  const auto size = std::size_t(fNE) * fNPhi;
+  if (G4Threading::IsMasterThread()) {
+    G4AutoLock lock(&gMergeMutex);
+    fMerged.assign(size, 0);
+  }
+
+  localActive = (fMode == kOn) || (fMode == kAuto && polarized);
+  if (!localActive) return;
+  if (!localCounts) localCounts = new std::vector<G4long>;
+  localCounts->assign(size, 0);
+}
+
+G4bool ModulationCurve::IsActive()
+{
+  return localActive;
+}
+
+G4int ModulationCurve::EnergyBin(G4double energy)
+{
+  if (energy < fEmin || energy >= fEmax) return -1;
+  return std::min(G4int((energy - fEmin) / (fEmax - fEmin) * fNE), fNE - 1);
+}
+
+G4int ModulationCurve::PhiBin(const G4ThreeVector& photonDir, const G4ThreeVector& electronDir)
+{
+  // frame around the photon: x = polarization axis projected on the
+  // plane normal to the photon, y = photon x x
+  const G4ThreeVector d = photonDir.unit();
+  G4ThreeVector x = kPolarizationAxis - kPolarizationAxis.dot(d) * d;
+  if (x.mag2() < 1e-12) return -1;   // photon along the axis: no azimuth
+  x = x.unit();
+  const G4ThreeVector y = d.cross(x);
+
+  G4double phi = std::atan2(electronDir.dot(y), electronDir.dot(x));
+  if (phi < 0.) phi += twopi;
+
+  return std::min(G4int(phi / twopi * fNPhi), fNPhi - 1);
+}
+
+void ModulationCurve::Fill(G4double energy, const G4ThreeVector& photonDir,
+                           const G4ThreeVector& electronDir)
+{
+  if (!localActive) return;
+  const G4int iE = EnergyBin(energy);
+  const G4int iPhi = (iE < 0) ? -1 : PhiBin(photonDir, electronDir);
+  if (iPhi < 0) return;
+  (*localCounts)[std::size_t(iE) * fNPhi + iPhi] += 1;
+}
+
+// Weighted linear least squares of N_i = a + b cos 2phi_i + c sin 2phi_i
+// (sigma_i^2 = max(N_i, 1)); mu = sqrt(b^2 + c^2) / a, phi0 = atan2(c, b) / 2,
+// errors from the covariance matrix of (a, b, c).
+ModulationCurve::Fit ModulationCurve::FitBin(const G4long* counts, G4int nPhi)
+{
+  Fit fit;
+  G4double m[3][3] = {}, v[3] = {};
+  G4long total = 0;
+  for (G4int i = 0; i < nPhi; ++i) {
+    const G4double phi = (i + 0.5) * twopi / nPhi;
+    const G4double f[3] = {1., std::cos(2.*phi), std::sin(2.*phi)};
+    const G4double w = 1. / std::max<G4double>(counts[i], 1.);
+    for (G4int r = 0; r < 3; ++r) {
+      v[r] += w * f[r] * counts[i];
+      for (G4int c = 0; c < 3; ++c) m[r][c] += w * f[r] * f[c];
+    }
+    total += counts[i];
+  }
+  if (total == 0 || nPhi < 4) return fit;
+
+  // covariance = inverse of the normal matrix (cofactors)
+  G4double cov[3][3];
+  for (G4int r = 0; r < 3; ++r) {
+    for (G4int c = 0; c < 3; ++c) {
+      const G4int r1 = (c + 1) % 3, r2 = (c + 2) % 3;
+      const G4int c1 = (r + 1) % 3, c2 = (r + 2) % 3;
+      cov[r][c] = m[r1][c1] * m[r2][c2] - m[r1][c2] * m[r2][c1];
+    }
+  }
+  const G4double det = m[0][0]*cov[0][0] + m[0][1]*cov[1][0] + m[0][2]*cov[2][0];
+  if (std::abs(det) <= 0.) return fit;
+  for (auto& row : cov) for (auto& x : row) x /= det;
+
+  G4double p[3] = {};
+  for (G4int r = 0; r < 3; ++r)
+    for (G4int c = 0; c < 3; ++c) p[r] += cov[r][c] * v[c];
+  const G4double a = p[0], b = p[1], c = p[2];
+  const G4double amp = std::hypot(b, c);
+  if (a <= 0.) return fit;
+
+  fit.mu   = amp / a;
+  fit.phi0 = 0.5 * std::atan2(c, b);
+
+  // error propagation: gradients of mu and phi0 in (a, b, c)
+  const G4double gMu[3]  = {-fit.mu / a,
+                            amp > 0. ? b / (a * amp) : 0.,
+                            amp > 0. ? c / (a * amp) : 0.};
+  const G4double gPhi[3] = {0.,
+                            amp > 0. ? -0.5 * c / (amp * amp) : 0.,
+                            amp > 0. ?  0.5 * b / (amp * amp) : 0.};
+  G4double varMu = 0., varPhi = 0.;
+  for (G4int r = 0; r < 3; ++r) {
+    for (G4int k = 0; k < 3; ++k) {
+      varMu  += gMu[r]  * cov[r][k] * gMu[k];
+      varPhi += gPhi[r] * cov[r][k] * gPhi[k];
+    }
+  }
+  fit.muErr   = std::sqrt(std::max(varMu, 0.));
+  fit.phi0Err = std::sqrt(std::max(varPhi, 0.));
+
+  for (G4int i = 0; i < nPhi; ++i) {
+    const G4double phi = (i + 0.5) * twopi / nPhi;
+    const G4double r = counts[i] - (a + b*std::cos(2.*phi) + c*std::sin(2.*phi));
+    fit.chi2 += r * r / std::max<G4double>(counts[i], 1.);
+  }
+  fit.ndf = nPhi - 3;
+  fit.ok  = true;
+  return fit;
+}
+
+void ModulationCurve::EndOfRun(G4int runID, const std::string& dir)
+{
+  if (localActive && localCounts) {
+    G4AutoLock lock(&gMergeMutex);
+    if (fMerged.size() == localCounts->size()) {
+      for (std::size_t i = 0; i < fMerged.size(); ++i) fMerged[i] += (*localCounts)[i];
+    }
+  }
+  localActive = false;
+  if (!G4Threading::IsMasterThread()) return;
+
+  G4long total = 0;
+  for (const auto n : fMerged) total += n;
+  if (total == 0) return;
+
+  const std::string file = (dir.empty() ? std::string() : dir + "/")
+                         + "modulation_run" + std::to_string(runID) + ".txt";
+  std::ofstream out(file);
+  out << "# modulation curve fit N(phi) = A [1 + mu cos 2(phi - phi0)], "
+      << fNPhi << " phi bins, phi0 from the polarization axis (Y)\n"
+      << "# E_low_keV E_high_keV nEvents mu mu_err phi0_deg phi0_err_deg chi2 ndf\n";
+
+  G4cout << "\n---- Modulation curve (run " << runID << "): " << total
+         << " photoabsorptions, " << file << " ----\n"
+         << "   E [keV]          N        mu   +- err    phi0 [deg]   chi2/ndf" << G4endl;
+
+  const G4double dE = (fEmax - fEmin) / fNE;
+  for (G4int iE = 0; iE < fNE; ++iE) {
+    const G4long* counts = fMerged.data() + std::size_t(iE) * fNPhi;
+    G4long n = 0;
+    for (G4int i = 0; i < fNPhi; ++i) n += counts[i];
+    if (n == 0) continue;
+
+    const auto fit = FitBin(counts, fNPhi);
+    const G4double lo = (fEmin + iE*dE) / keV, hi = (fEmin + (iE + 1)*dE) / keV;
+    out << lo << " " << hi << " " << n << " " << fit.mu << " " << fit.muErr << " "
+        << fit.phi0/deg << " " << fit.phi0Err/deg << " " << fit.chi2 << " " << fit.ndf << "\n";
+
+    G4cout << std::fixed << std::setprecision(2)
+           << std::setw(6) << lo << " - " << std::setw(6) << hi
+           << std::setw(10) << n
+           << std::setprecision(4) << std::setw(10) << fit.mu << " +- " << std::setw(6) << fit.muErr
+           << std::setprecision(1) << std::setw(9) << fit.phi0/deg << " +- " << std::setw(4) << fit.phi0Err/deg
+           << std::setprecision(2) << std::setw(8) << (fit.ndf > 0 ? fit.chi2 / fit.ndf : 0.)
+           << G4endl;
+  }
+  G4cout << std::defaultfloat << std::setprecision(6)
+         << "--------------------------------------" << G4endl;
+}
+
+} // namespace B3a
@@ -0,0 +1,89 @@
+/// \file B3/B3a/src/ModulationMessenger.cc
+/// \brief Implementation of the B3a::ModulationMessenger class
+
+#include "ModulationMessenger.hh"
+#include "ModulationCurve.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+#include <sstream>
+
+namespace B3a {
+
+ModulationMessenger::ModulationMessenger()
+{
+  fDir = new G4UIdirectory("/B3/modulation/");
+  fDir->SetGuidance("Modulation curve of the truth photoelectrons, fitted at the end of run");
+
+  fModeCmd = new G4UIcmdWithAString("/B3/modulation/mode", this);
+  fModeCmd->SetGuidance("auto: only with a polarized spectrum (default);");
+  fModeCmd->SetGuidance("on: always (e.g. residual modulation of unpolarized runs); off");
+  fModeCmd->SetParameterName("mode", false);
+  fModeCmd->SetCandidates("auto on off");
+  fModeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fModeCmd->SetToBeBroadcasted(false);
+
+  fEnergyCmd = new G4UIcommand("/B3/modulation/energyBins", this);
+  fEnergyCmd->SetGuidance("Photon energy bins of the curves: n emin emax unit");
+  fEnergyCmd->SetGuidance("(default 10 2 22 keV)");
+  auto* n = new G4UIparameter("n", 'i', false);
+  n->SetParameterRange("n > 0");
+  fEnergyCmd->SetParameter(n);
+  fEnergyCmd->SetParameter(new G4UIparameter("emin", 'd', false));
+  fEnergyCmd->SetParameter(new G4UIparameter("emax", 'd', false));
+  auto* unit = new G4UIparameter("unit", 's', true);
+  unit->SetDefaultValue("keV");
+  fEnergyCmd->SetParameter(unit);
+  fEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fEnergyCmd->SetToBeBroadcasted(false);
+
+  fPhiBinsCmd = new G4UIcmdWithAnInteger("/B3/modulation/phiBins", this);
+  fPhiBinsCmd->SetGuidance("Azimuth bins in [0, 360) deg (default 36)");
+  fPhiBinsCmd->SetParameterName("n", false);
+  fPhiBinsCmd->SetRange("n >= 4");
+  fPhiBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPhiBinsCmd->SetToBeBroadcasted(false);
+}
+
+ModulationMessenger::~ModulationMessenger()
+{
+  delete fModeCmd;
+  delete fEnergyCmd;
+  delete fPhiBinsCmd;
+  delete fDir;
+}
+
+void ModulationMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  if (cmd == fModeCmd) {
+
+    if      (value == "on")  ModulationCurve::SetMode(ModulationCurve::kOn);
+    else if (value == "off") ModulationCurve::SetMode(ModulationCurve::kOff);
+    else                     ModulationCurve::SetMode(ModulationCurve::kAuto);
+
+  } else if (cmd == fEnergyCmd) {
+
+    std::istringstream is(value);
+    G4int n;
+    G4double emin, emax;
+    G4String unit;
+    is >> n >> emin >> emax >> unit;
+    const G4double u = G4UIcommand::ValueOf(unit);
+    if (emax <= emin) {
+      G4cerr << "/B3/modulation/energyBins: emax must be above emin" << G4endl;
+      return;
+    }
+    ModulationCurve::SetEnergyBins(n, emin * u, emax * u);
+
+  } else if (cmd == fPhiBinsCmd) {
+
+    ModulationCurve::SetPhiBins(fPhiBinsCmd->GetNewIntValue(value));
+
+  }
+}
+
+} // namespace B3a
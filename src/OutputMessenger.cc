@@ -0,0 +1,118 @@
+/// \file B3/B3a/src/OutputMessenger.cc
+/// \brief Implementation of the B3a::OutputMessenger class
+
+#include "OutputMessenger.hh"
+#include "RunAction.hh"
+#include "Checkpoint.hh"
+#include "HitBuffer.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAString.hh"
+
+namespace B3a {
+
+OutputMessenger::OutputMessenger()
+{
+  fDir = new G4UIdirectory("/B3/output/");
+  fDir->SetGuidance("Per-thread ROOT output files");
+
+  fRotateEventsCmd = new G4UIcmdWithAnInteger("/B3/output/rotateEvents", this);
+  fRotateEventsCmd->SetGuidance("Start a new numbered file after this many written events");
+  fRotateEventsCmd->SetGuidance("per thread (0 = no limit). The chunks are listed in");
+  fRotateEventsCmd->SetGuidance("tpc_hits_t<N>_index.txt as soon as they are closed.");
+  fRotateEventsCmd->SetParameterName("events", false);
+  fRotateEventsCmd->SetRange("events >= 0");
+  fRotateEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRotateEventsCmd->SetToBeBroadcasted(false);
+
+  fRotateSizeCmd = new G4UIcmdWithADouble("/B3/output/rotateSize", this);
+  fRotateSizeCmd->SetGuidance("Start a new numbered file once this many MB have been");
+  fRotateSizeCmd->SetGuidance("written to the current one (0 = no limit). Files are only");
+  fRotateSizeCmd->SetGuidance("switched between events.");
+  fRotateSizeCmd->SetParameterName("MB", false);
+  fRotateSizeCmd->SetRange("MB >= 0.");
+  fRotateSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRotateSizeCmd->SetToBeBroadcasted(false);
+
+  fCheckpointCmd = new G4UIcmdWithAnInteger("/B3/output/checkpointEvery", this);
+  fCheckpointCmd->SetGuidance("Every this many events per thread, flush the trees (AutoSave)");
+  fCheckpointCmd->SetGuidance("and record the events on disk in tpc_hits_t<N>_run<R>.ckpt");
+  fCheckpointCmd->SetGuidance("(0 = off). An interrupted job continues with");
+  fCheckpointCmd->SetGuidance("  exampleB3a --resume <same macro>");
+  fCheckpointCmd->SetParameterName("events", false);
+  fCheckpointCmd->SetRange("events >= 0");
+  fCheckpointCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCheckpointCmd->SetToBeBroadcasted(false);
+
+  fMaxHitsCmd = new G4UIcmdWithAnInteger("/B3/output/maxHits", this);
+  fMaxHitsCmd->SetGuidance("Most hits an event writes to one entry of the 'steps' tree");
+  fMaxHitsCmd->SetGuidance("(0 = no limit); larger events are handled as set by");
+  fMaxHitsCmd->SetGuidance("/B3/output/overflow.");
+  fMaxHitsCmd->SetParameterName("hits", false);
+  fMaxHitsCmd->SetRange("hits >= 0");
+  fMaxHitsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMaxHitsCmd->SetToBeBroadcasted(false);
+
+  fOverflowCmd = new G4UIcmdWithAString("/B3/output/overflow", this);
+  fOverflowCmd->SetGuidance("Events above /B3/output/maxHits hits:");
+  fOverflowCmd->SetGuidance("  spill    written in several entries with the same eventID");
+  fOverflowCmd->SetGuidance("  coarsen  consecutive steps of a track merged until they fit");
+  fOverflowCmd->SetParameterName("policy", false);
+  fOverflowCmd->SetCandidates("spill coarsen");
+  fOverflowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fOverflowCmd->SetToBeBroadcasted(false);
+
+  fKeepCmd = new G4UIcmdWithAnInteger("/B3/output/keepCapacity", this);
+  fKeepCmd->SetGuidance("Hits (tracks) the per-event buffers keep room for between events");
+  fKeepCmd->SetGuidance("(default 100000); buffers that grew above it are released.");
+  fKeepCmd->SetParameterName("hits", false);
+  fKeepCmd->SetRange("hits >= 0");
+  fKeepCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fKeepCmd->SetToBeBroadcasted(false);
+}
+
+OutputMessenger::~OutputMessenger()
+{
+  delete fRotateEventsCmd;
+  delete fRotateSizeCmd;
+  delete fCheckpointCmd;
+  delete fMaxHitsCmd;
+  delete fOverflowCmd;
+  delete fKeepCmd;
+  delete fDir;
+}
+
+void OutputMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  if (cmd == fRotateEventsCmd) {
+
+    fRotateEvents = fRotateEventsCmd->GetNewIntValue(value);
+    RunAction::SetRotation(fRotateEvents, fRotateMB);
+
+  } else if (cmd == fRotateSizeCmd) {
+
+    fRotateMB = fRotateSizeCmd->GetNewDoubleValue(value);
+    RunAction::SetRotation(fRotateEvents, fRotateMB);
+
+  } else if (cmd == fCheckpointCmd) {
+
+    Checkpoint::SetInterval(fCheckpointCmd->GetNewIntValue(value));
+
+  } else if (cmd == fMaxHitsCmd) {
+
+    HitBuffer::SetMaxHits(fMaxHitsCmd->GetNewIntValue(value));
+
+  } else if (cmd == fOverflowCmd) {
+
+    HitBuffer::SetPolicy(value == "coarsen" ? HitBuffer::kCoarsen : HitBuffer::kSpill);
+
+  } else if (cmd == fKeepCmd) {
+
+    HitBuffer::SetKeepCapacity(fKeepCmd->GetNewIntValue(value));
+
+  }
+}
+
+} // namespace B3a
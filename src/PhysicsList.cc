@@ -8,12 +8,32 @@
 #include "G4RadioactiveDecayPhysics.hh"
 #include "G4EmLivermorePolarizedPhysics.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4EmConfigurator.hh"
+#include "G4EmParameters.hh"
+#include "G4LossTableManager.hh"
+#include "G4FastSimulationPhysics.hh"
+#include "G4StepLimiterPhysics.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4UserLimits.hh"
+#include "G4UnitsTable.hh"
+#include "G4GeometrySampler.hh"
+#include "G4ImportanceBiasing.hh"
+
+#include <cfloat>
+
+#include "PhysicsListMessenger.hh"
+#include "G4LivermorePolarizedPhotoElectricGDModel.hh"
+#include "ImportanceWorld.hh"
+#include "AdjointPhysics.hh"
 
 namespace B3
 {
 
 
-PhysicsList::PhysicsList()
+PhysicsList::PhysicsList(G4bool adjoint)
 {
   SetVerboseLevel(1);
 
@@ -29,17 +49,171 @@ PhysicsList::PhysicsList()
   //RegisterPhysics(new G4EmLivermorePhysics());
   RegisterPhysics(new G4EmLivermorePolarizedPhysics());
 
+  // Fast simulation hook for e- (ElectronTrackLibraryModel in the gas)
+  auto* fastSimulation = new G4FastSimulationPhysics();
+  fastSimulation->ActivateFastSimulation("e-");
+  RegisterPhysics(fastSimulation);
+
+  // G4StepLimiter + G4UserSpecialCuts, driven by the regions' G4UserLimits
+  RegisterPhysics(new G4StepLimiterPhysics());
+
+  // Reverse MC: the adjoint processes are built on the forward compt and
+  // phot, which G4GammaGeneralProcess would hide
+  if (adjoint) {
+    G4EmParameters::Instance()->SetGeneralProcessActive(false);
+    RegisterPhysics(new AdjointPhysics());
+  }
+
+  // Default cuts: 1 um everywhere, as before the cuts were configurable
+  for (const G4String p : {"gamma", "e-", "e+"}) {
+    fRegionSettings["DefaultRegionForTheWorld"].cuts[p] = 0.001*mm;
+    fRegionSettings["TPCGasRegion"].cuts[p]             = 0.001*mm;
+  }
+
+  fMessenger = new PhysicsListMessenger(this);
+}
+
+PhysicsList::~PhysicsList()
+{
+  delete fMessenger;
+  for (auto* sampler : fSamplers) delete sampler;
+}
+
+void PhysicsList::AddImportanceBiasing(const G4String& particle)
+{
+  for (auto* sampler : fSamplers) {
+    if (sampler->GetParticleName() == particle) return;
+  }
+
+  // the world volume is set by G4ImportanceBiasing from the importance store
+  auto* sampler = new G4GeometrySampler(nullptr, particle);
+  sampler->SetParallel(true);
+  fSamplers.push_back(sampler);
+
+  RegisterPhysics(new G4ImportanceBiasing(sampler, ImportanceWorld::kWorldName));
+}
+
+void PhysicsList::SetGasPhotoElectricModel(const G4String& name)
+{
+  fUseGDPhotoElectric = (name == "gd");
+
+  // the configurator looks the process up by name ("phot"), which is
+  // hidden inside G4GammaGeneralProcess when that one is active
+  if (fUseGDPhotoElectric) {
+    G4EmParameters::Instance()->SetGeneralProcessActive(false);
+  }
+}
+
+void PhysicsList::ConstructProcess()
+{
+  G4VModularPhysicsList::ConstructProcess();
+
+  if (!fUseGDPhotoElectric) return;
+
+  // Replace the photoelectric model in the gas only; the world keeps
+  // the Livermore polarized one. One model instance per thread.
+  auto* gdModel = new G4LivermorePolarizedPhotoElectricGDModel();
+  G4LossTableManager::Instance()->EmConfigurator()->SetExtraEmModel(
+      "gamma", "phot", gdModel, "TPCGasRegion",
+      gdModel->LowEnergyLimit(), gdModel->HighEnergyLimit());
 }
 
 
 void PhysicsList::SetCuts()
 {
   // Global production cuts (applies everywhere unless a Region overrides)
-  SetCutValue(0.001*mm, "gamma");
-  SetCutValue(0.001*mm, "e-");
-  SetCutValue(0.001*mm, "e+");
+  for (const auto& [particle, cut] : fRegionSettings["DefaultRegionForTheWorld"].cuts) {
+    SetCutValue(cut, particle);
+  }
 
   G4VUserPhysicsList::SetCuts();
+
+  ApplyRegionSettings();
+}
+
+G4String PhysicsList::RegionName(const G4String& alias)
+{
+  if (alias == "world") return "DefaultRegionForTheWorld";
+  if (alias == "gas")   return "TPCGasRegion";
+  return alias;
+}
+
+// --------------------------------------------------
+// Push the stored settings to the regions that exist. Called from
+// SetCuts() (i.e. after the geometry is built) and again on every
+// command in Idle state; the cuts table picks up the changes at the
+// next BeamOn.
+// --------------------------------------------------
+void PhysicsList::ApplyRegionSettings()
+{
+  auto* store = G4RegionStore::GetInstance();
+
+  for (const auto& [name, rs] : fRegionSettings) {
+    auto* region = store->GetRegion(name, false);
+    if (!region) continue;   // not built yet
+
+    // Geant4 gives regions without cuts a copy of the default ones only
+    // at the first BeamOn; SetParticleCuts needs an object to write into
+    if (!rs.cuts.empty() && !region->GetProductionCuts()) {
+      region->SetProductionCuts(
+          G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts()->GetCopy());
+    }
+
+    for (const auto& [particle, cut] : rs.cuts) {
+      SetParticleCuts(cut, particle, region);
+    }
+
+    if (rs.maxStep > 0. || rs.minEkin > 0.) {
+      auto* limits = region->GetUserLimits();
+      if (!limits) {
+        limits = new G4UserLimits();
+        region->SetUserLimits(limits);
+      }
+      limits->SetMaxAllowedStep(rs.maxStep > 0. ? rs.maxStep : DBL_MAX);
+      limits->SetUserMinEkine(rs.minEkin > 0. ? rs.minEkin : 0.);
+    } else if (auto* limits = region->GetUserLimits()) {
+      limits->SetMaxAllowedStep(DBL_MAX);
+      limits->SetUserMinEkine(0.);
+    }
+  }
+}
+
+void PhysicsList::SetRegionCut(const G4String& region, G4double cut,
+                               const G4String& particle)
+{
+  auto& rs = fRegionSettings[RegionName(region)];
+  if (particle == "all") {
+    for (const G4String p : {"gamma", "e-", "e+", "proton"}) rs.cuts[p] = cut;
+  } else {
+    rs.cuts[particle] = cut;
+  }
+  ApplyRegionSettings();
+}
+
+void PhysicsList::SetRegionMaxStep(const G4String& region, G4double maxStep)
+{
+  fRegionSettings[RegionName(region)].maxStep = maxStep;
+  ApplyRegionSettings();
+}
+
+void PhysicsList::SetRegionMinEkin(const G4String& region, G4double minEkin)
+{
+  fRegionSettings[RegionName(region)].minEkin = minEkin;
+  ApplyRegionSettings();
+}
+
+void PhysicsList::PrintRegionSettings() const
+{
+  G4cout << "\n---- Region cuts and limits (/B3/cuts/, /B3/limits/) ----" << G4endl;
+  for (const auto& [name, rs] : fRegionSettings) {
+    G4cout << "  " << name << G4endl;
+    for (const auto& [particle, cut] : rs.cuts) {
+      G4cout << "      cut " << particle << " = " << G4BestUnit(cut, "Length") << G4endl;
+    }
+    if (rs.maxStep > 0.) G4cout << "      maxStep = " << G4BestUnit(rs.maxStep, "Length") << G4endl;
+    if (rs.minEkin > 0.) G4cout << "      minEkin = " << G4BestUnit(rs.minEkin, "Energy") << G4endl;
+  }
+  G4cout << "---------------------------------------------------------" << G4endl;
 }
 
 
@@ -0,0 +1,139 @@
+/// \file B3/B3a/src/PhysicsListMessenger.cc
+
+#include "PhysicsListMessenger.hh"
+#include "PhysicsList.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+namespace B3 {
+
+PhysicsListMessenger::PhysicsListMessenger(PhysicsList* physics)
+  : fPhysics(physics)
+{
+  fDir = new G4UIdirectory("/B3/phys/");
+  fDir->SetGuidance("Physics list options (set before /run/initialize)");
+
+  fGasPECmd = new G4UIcmdWithAString("/B3/phys/gasPhotoElectric", this);
+  fGasPECmd->SetGuidance("Photoelectric final state in TPCGasRegion:");
+  fGasPECmd->SetGuidance("  livermore : default of G4EmLivermorePolarizedPhysics");
+  fGasPECmd->SetGuidance("  gd        : G4LivermorePolarizedPhotoElectricGDModel");
+  fGasPECmd->SetParameterName("model", false);
+  fGasPECmd->SetCandidates("livermore gd");
+  fGasPECmd->AvailableForStates(G4State_PreInit);
+  fGasPECmd->SetToBeBroadcasted(false);
+
+  fBiasCmd = new G4UIcmdWithAString("/B3/phys/importanceBiasing", this);
+  fBiasCmd->SetGuidance("Importance splitting / Russian roulette for one particle");
+  fBiasCmd->SetGuidance("on the shells around the TPC (see /B3/bias/); repeat per particle");
+  fBiasCmd->SetParameterName("particle", false);
+  fBiasCmd->AvailableForStates(G4State_PreInit);
+  fBiasCmd->SetToBeBroadcasted(false);
+
+  // ---- production cuts per region ----
+  fCutsDir = new G4UIdirectory("/B3/cuts/");
+  fCutsDir->SetGuidance("Production cuts per region (world, gas or a G4Region name)");
+
+  fCutCmd = new G4UIcommand("/B3/cuts/setCut", this);
+  fCutCmd->SetGuidance("Range cut for one region: setCut <region> <value> <unit> [particle]");
+  fCutCmd->SetGuidance("particle = gamma, e-, e+, proton or all (default)");
+  auto* pRegion = new G4UIparameter("region", 's', false);
+  auto* pValue  = new G4UIparameter("value", 'd', false);
+  pValue->SetParameterRange("value > 0.");
+  auto* pUnit   = new G4UIparameter("unit", 's', true);
+  pUnit->SetDefaultValue("mm");
+  auto* pPart   = new G4UIparameter("particle", 's', true);
+  pPart->SetDefaultValue("all");
+  pPart->SetParameterCandidates("all gamma e- e+ proton");
+  fCutCmd->SetParameter(pRegion);
+  fCutCmd->SetParameter(pValue);
+  fCutCmd->SetParameter(pUnit);
+  fCutCmd->SetParameter(pPart);
+  fCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCutCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcommand("/B3/cuts/print", this);
+  fPrintCmd->SetGuidance("Print the cuts and limits of every configured region");
+  fPrintCmd->SetToBeBroadcasted(false);
+
+  // ---- tracking limits per region (G4UserLimits) ----
+  fLimitsDir = new G4UIdirectory("/B3/limits/");
+  fLimitsDir->SetGuidance("G4UserLimits per region (world, gas or a G4Region name)");
+
+  auto makeLimitCmd = [this](const char* path, const char* guidance,
+                             const char* defUnit) {
+    auto* cmd = new G4UIcommand(path, this);
+    cmd->SetGuidance(guidance);
+    cmd->SetGuidance("A value <= 0 removes the limit.");
+    auto* r = new G4UIparameter("region", 's', false);
+    auto* v = new G4UIparameter("value", 'd', false);
+    auto* u = new G4UIparameter("unit", 's', true);
+    u->SetDefaultValue(defUnit);
+    cmd->SetParameter(r);
+    cmd->SetParameter(v);
+    cmd->SetParameter(u);
+    cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    cmd->SetToBeBroadcasted(false);
+    return cmd;
+  };
+  fMaxStepCmd = makeLimitCmd("/B3/limits/maxStep",
+                             "Maximum step length in a region: maxStep <region> <value> <unit>",
+                             "mm");
+  fMinEkinCmd = makeLimitCmd("/B3/limits/minEkin",
+                             "Tracks below this kinetic energy are stopped and deposit it locally",
+                             "keV");
+}
+
+PhysicsListMessenger::~PhysicsListMessenger()
+{
+  delete fGasPECmd;
+  delete fBiasCmd;
+  delete fDir;
+  delete fCutCmd;
+  delete fPrintCmd;
+  delete fCutsDir;
+  delete fMaxStepCmd;
+  delete fMinEkinCmd;
+  delete fLimitsDir;
+}
+
+void PhysicsListMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  if (cmd == fGasPECmd) {
+
+    fPhysics->SetGasPhotoElectricModel(value);
+
+  } else if (cmd == fBiasCmd) {
+
+    fPhysics->AddImportanceBiasing(value);
+
+  } else if (cmd == fCutCmd) {
+
+    std::istringstream is(value);
+    G4String region, unit, particle;
+    G4double v;
+    is >> region >> v >> unit >> particle;
+    fPhysics->SetRegionCut(region, v*G4UIcommand::ValueOf(unit), particle);
+
+  } else if (cmd == fPrintCmd) {
+
+    fPhysics->PrintRegionSettings();
+
+  } else if (cmd == fMaxStepCmd || cmd == fMinEkinCmd) {
+
+    std::istringstream is(value);
+    G4String region, unit;
+    G4double v;
+    is >> region >> v >> unit;
+    v *= G4UIcommand::ValueOf(unit);
+    if (cmd == fMaxStepCmd) fPhysics->SetRegionMaxStep(region, v);
+    else                    fPhysics->SetRegionMinEkin(region, v);
+
+  }
+}
+
+} // namespace B3
@@ -0,0 +1,112 @@
+/// \file B3/B3a/src/PixelReadoutMessenger.cc
+
+#include "PixelReadoutMessenger.hh"
+#include "PixelReadoutScorer.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4Exception.hh"
+
+#include <climits>
+#include <sstream>
+
+namespace B3 {
+
+PixelReadoutMessenger::PixelReadoutMessenger()
+{
+  fDir = new G4UIdirectory("/B3/readout/");
+  fDir->SetGuidance("Pixelated readout of the gas end cap (tree 'pixels'), per run");
+
+  fEnableCmd = new G4UIcmdWithABool("/B3/readout/enable", this);
+  fEnableCmd->SetGuidance("Score the energy per pixel and write sparse pixel lists");
+  fEnableCmd->SetParameterName("flag", true);
+  fEnableCmd->SetDefaultValue(true);
+
+  fGridCmd = new G4UIcommand("/B3/readout/grid", this);
+  fGridCmd->SetGuidance("Pixel grid centred on the gas axis: grid <nx> <ny> <pitch> [unit=mm]");
+  auto* pNx = new G4UIparameter("nx", 'i', false);
+  pNx->SetParameterRange("nx > 0");
+  auto* pNy = new G4UIparameter("ny", 'i', false);
+  pNy->SetParameterRange("ny > 0");
+  auto* pPitch = new G4UIparameter("pitch", 'd', false);
+  pPitch->SetParameterRange("pitch > 0.");
+  auto* pUnit = new G4UIparameter("unit", 's', true);
+  pUnit->SetDefaultValue("mm");
+  fGridCmd->SetParameter(pNx);
+  fGridCmd->SetParameter(pNy);
+  fGridCmd->SetParameter(pPitch);
+  fGridCmd->SetParameter(pUnit);
+
+  fSlicesCmd = new G4UIcmdWithAnInteger("/B3/readout/zSlices", this);
+  fSlicesCmd->SetGuidance("Number of slices along the drift (z) direction");
+  fSlicesCmd->SetParameterName("nz", false);
+  fSlicesCmd->SetRange("nz > 0");
+
+  fStepsCmd = new G4UIcmdWithABool("/B3/readout/writeSteps", this);
+  fStepsCmd->SetGuidance("Also write the per-step tree (false: pixel lists only)");
+  fStepsCmd->SetParameterName("flag", true);
+  fStepsCmd->SetDefaultValue(true);
+
+  // shared settings, read by the workers at the start of the run
+  for (G4UIcommand* cmd : {static_cast<G4UIcommand*>(fEnableCmd), fGridCmd,
+                           static_cast<G4UIcommand*>(fSlicesCmd),
+                           static_cast<G4UIcommand*>(fStepsCmd)}) {
+    cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    cmd->SetToBeBroadcasted(false);
+  }
+}
+
+PixelReadoutMessenger::~PixelReadoutMessenger()
+{
+  delete fEnableCmd;
+  delete fGridCmd;
+  delete fSlicesCmd;
+  delete fStepsCmd;
+  delete fDir;
+}
+
+void PixelReadoutMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  auto& settings = PixelReadoutScorer::GetSettings();
+
+  if (cmd == fEnableCmd) {
+
+    settings.enabled = fEnableCmd->GetNewBoolValue(value);
+
+  } else if (cmd == fGridCmd) {
+
+    std::istringstream is(value);
+    G4int nx, ny;
+    G4double pitch;
+    G4String unit;
+    is >> nx >> ny >> pitch >> unit;
+    if (G4double(nx)*ny*settings.nz > INT_MAX) {
+      G4Exception("PixelReadoutMessenger", "B3Readout001", JustWarning,
+                  "Too many pixels for an int index; grid unchanged.");
+      return;
+    }
+    settings.nx    = nx;
+    settings.ny    = ny;
+    settings.pitch = pitch*G4UIcommand::ValueOf(unit);
+
+  } else if (cmd == fSlicesCmd) {
+
+    const G4int nz = fSlicesCmd->GetNewIntValue(value);
+    if (G4double(settings.nx)*settings.ny*nz > INT_MAX) {
+      G4Exception("PixelReadoutMessenger", "B3Readout001", JustWarning,
+                  "Too many pixels for an int index; slices unchanged.");
+      return;
+    }
+    settings.nz = nz;
+
+  } else if (cmd == fStepsCmd) {
+
+    settings.writeSteps = fStepsCmd->GetNewBoolValue(value);
+
+  }
+}
+
+} // namespace B3
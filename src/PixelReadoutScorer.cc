@@ -0,0 +1,83 @@
+/// \file B3/B3a/src/PixelReadoutScorer.cc
+/// \brief Implementation of the B3::PixelReadoutScorer class
+
+#include "PixelReadoutScorer.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VSolid.hh"
+#include "G4VTouchable.hh"
+#include "G4NavigationHistory.hh"
+#include "G4HCofThisEvent.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace B3 {
+
+PixelReadoutScorer::Settings& PixelReadoutScorer::GetSettings()
+{
+  static Settings settings;
+  return settings;
+}
+
+PixelReadoutScorer::PixelReadoutScorer(const G4String& name)
+  : G4VPrimitiveScorer(name)
+{}
+
+void PixelReadoutScorer::Initialize(G4HCofThisEvent* HCE)
+{
+  fEvtMap = new G4THitsMap<G4double>(GetMultiFunctionalDetector()->GetName(), GetName());
+  if (fHCID < 0) fHCID = GetCollectionID(0);
+  HCE->AddHitsCollection(fHCID, fEvtMap);
+}
+
+void PixelReadoutScorer::clear()
+{
+  fEvtMap->clear();
+}
+
+G4bool PixelReadoutScorer::ProcessHits(G4Step* step, G4TouchableHistory*)
+{
+  if (!GetSettings().enabled) return false;
+
+  const G4double edep = step->GetTotalEnergyDeposit();
+  if (edep <= 0.) return false;
+
+  const auto* pre = step->GetPreStepPoint();
+  const G4ThreeVector mid = 0.5*(pre->GetPosition() + step->GetPostStepPoint()->GetPosition());
+  const auto* touchable = pre->GetTouchable();
+  const G4ThreeVector local = touchable->GetHistory()->GetTopTransform().TransformPoint(mid);
+
+  // weighted like the steps tree: the expected energy under importance biasing
+  AddDeposit(local, touchable->GetSolid(), edep * step->GetTrack()->GetWeight());
+  return true;
+}
+
+void PixelReadoutScorer::AddDeposit(const G4ThreeVector& local,
+                                    const G4VSolid* gasSolid, G4double edep)
+{
+  const auto& s = GetSettings();
+  if (!s.enabled || !fEvtMap) return;
+
+  G4ThreeVector pmin, pmax;
+  gasSolid->BoundingLimits(pmin, pmax);
+
+  const G4int ix = G4int(std::floor(local.x()/s.pitch + 0.5*s.nx));
+  const G4int iy = G4int(std::floor(local.y()/s.pitch + 0.5*s.ny));
+  const G4int iz = G4int(std::floor((local.z() - pmin.z()) / (pmax.z() - pmin.z()) * s.nz));
+  if (ix < 0 || ix >= s.nx || iy < 0 || iy >= s.ny) return;
+
+  const G4int index = ((std::min(std::max(iz, 0), s.nz - 1))*s.ny + iy)*s.nx + ix;
+  fEvtMap->add(index, edep);
+}
+
+void PixelReadoutScorer::Decode(G4int index, G4int& ix, G4int& iy, G4int& iz)
+{
+  const auto& s = GetSettings();
+  ix = index % s.nx;
+  iy = (index / s.nx) % s.ny;
+  iz = index / (s.nx*s.ny);
+}
+
+} // namespace B3
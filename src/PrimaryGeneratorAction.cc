@@ -3,10 +3,16 @@
 
 #include "PrimaryGeneratorAction.hh"
 #include "PrimaryGeneratorMessenger.hh"
+#include "ElectronTrackLibrary.hh"
+#include "Checkpoint.hh"
+#include "Timing.hh"
 
 #include "G4Event.hh"
 #include "G4ParticleGun.hh"
 #include "G4ParticleTable.hh"
+#include "G4Electron.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4PhysicalConstants.hh"
 #include "Randomize.hh"         // G4UniformRand, G4RandGauss
@@ -101,6 +107,7 @@ void PrimaryGeneratorAction::LoadSpectrum(const G4String& filename)
   fBins.clear();
   fCdf.clear();
   fTotalW = 0.0;
+  fPolarized = false;
 
   // --- 1) Detect format from first data line ---
   std::string line;
@@ -249,6 +256,7 @@ void PrimaryGeneratorAction::LoadSpectrum(const G4String& filename)
   for (const auto& b : fBins) {
     cum += (b.weight > 0.0) ? b.weight : 0.0;
     fCdf.push_back(cum);
+    if (b.weight > 0.0 && b.polMean > 0.0) fPolarized = true;
   }
   fTotalW = cum;
 
@@ -327,6 +335,26 @@ G4ThreeVector PrimaryGeneratorAction::SamplePolarizationVector(G4double polMean,
 // --------------------------------------------------
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
+  B3_TIME(kGenerate);
+
+  // serial run managers: the event's seeds must not depend on the events
+  // before it, or --resume would not continue the run
+  B3a::Checkpoint::SeedEvent(anEvent->GetEventID());
+
+  // 0) track-library build mode: one e- from the gas centre along +z
+  auto& library = ElectronTrackLibrary::Instance();
+  if (library.IsRecording()) {
+    const auto* gasPV =
+      G4PhysicalVolumeStore::GetInstance()->GetVolume("TPCGas", false);
+    fParticleGun->SetParticleDefinition(G4Electron::Definition());
+    fParticleGun->SetParticleEnergy(library.RecordEnergy(anEvent->GetEventID()));
+    fParticleGun->SetParticlePosition(gasPV ? gasPV->GetTranslation() : G4ThreeVector());
+    fParticleGun->SetParticleMomentumDirection(G4ThreeVector(0., 0., 1.));
+    fParticleGun->SetParticlePolarization(G4ThreeVector());
+    fParticleGun->GeneratePrimaryVertex(anEvent);
+    return;
+  }
+
   // 1) energy & polarization params from spectrum
   G4double polMean  = 0.0;
   G4double polSigma = 0.0;
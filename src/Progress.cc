@@ -0,0 +1,157 @@
+/// \file B3/B3a/src/Progress.cc
+/// \brief Implementation of the B3a::Progress class
+
+#include "Progress.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace B3a {
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// shared by the workers
+std::atomic<G4long> gEvents{0};
+std::atomic<G4long> gHits{0};
+std::atomic<G4long> gBytes{0};
+
+// the run, set by the master before the monitor starts
+G4int  gRunID = 0;
+G4long gTotal = 0;
+Clock::time_point gStart;
+
+// previous report (monitor thread only)
+G4long gLastEvents = 0;
+Clock::time_point gLast;
+
+// monitor thread; never destroyed, so that a job that ends without
+// EndOfRun does not terminate on a joinable std::thread
+std::thread* gMonitor = nullptr;
+std::mutex gStopMutex;
+std::condition_variable gStopCondition;
+G4bool gStop = false;
+
+std::string Duration(G4double s)
+{
+  if (s < 0.) return "?";
+  const long t = long(s + 0.5);
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%ld:%02ld:%02ld", t / 3600, t / 60 % 60, t % 60);
+  return buf;
+}
+}
+
+void Progress::BeginOfRun(G4int runID, G4long events)
+{
+  if (!IsEnabled() || gMonitor) return;
+
+  gEvents = 0;
+  gHits   = 0;
+  gBytes  = 0;
+  gRunID  = runID;
+  gTotal  = events;
+  gStart  = gLast = Clock::now();
+  gLastEvents = 0;
+  gStop = false;
+  gMonitor = new std::thread(&Progress::Monitor);
+}
+
+void Progress::EndOfRun()
+{
+  if (!gMonitor) return;
+
+  {
+    std::lock_guard<std::mutex> lock(gStopMutex);
+    gStop = true;
+  }
+  gStopCondition.notify_all();
+  gMonitor->join();
+  delete gMonitor;
+  gMonitor = nullptr;
+
+  Report(true);
+}
+
+void Progress::AddEvent(G4long hits)
+{
+  if (!IsEnabled()) return;
+  gEvents.fetch_add(1, std::memory_order_relaxed);
+  gHits.fetch_add(hits, std::memory_order_relaxed);
+}
+
+void Progress::AddBytes(G4long bytes)
+{
+  if (IsEnabled()) gBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void Progress::Monitor()
+{
+  const auto interval = std::chrono::duration<G4double>(fInterval);
+  std::unique_lock<std::mutex> lock(gStopMutex);
+  while (!gStopCondition.wait_for(lock, interval, [] { return gStop; })) {
+    Report(false);
+  }
+}
+
+void Progress::Report(G4bool done)
+{
+  const auto now = Clock::now();
+  const G4double elapsed = std::chrono::duration<G4double>(now - gStart).count();
+  const G4double sinceLast = std::chrono::duration<G4double>(now - gLast).count();
+  const G4long events = gEvents.load(std::memory_order_relaxed);
+  const G4long hits   = gHits.load(std::memory_order_relaxed);
+  const G4double mb   = gBytes.load(std::memory_order_relaxed) / (1024. * 1024.);
+
+  const G4double rate    = sinceLast > 0. ? (events - gLastEvents) / sinceLast : 0.;
+  const G4double average = elapsed > 0. ? events / elapsed : 0.;
+  const G4double hitRate = elapsed > 0. ? hits / elapsed : 0.;
+  const G4double eta = done ? 0.
+    : (average > 0. ? std::max<G4long>(0, gTotal - events) / average : -1.);
+  gLast = now;
+  gLastEvents = events;
+
+  // not a Geant4 thread: plain std::cout, one line per report
+  if (!done) {
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1)
+         << "---- Progress (run " << gRunID << "): " << events << " / " << gTotal
+         << " events (" << (gTotal > 0 ? 100. * events / gTotal : 0.) << "%), "
+         << rate << " ev/s now, " << average << " ev/s average, "
+         << std::setprecision(0) << hitRate << " hits/s, "
+         << std::setprecision(1) << mb << " MB written, elapsed " << Duration(elapsed)
+         << ", ETA " << Duration(eta) << "\n";
+    std::cout << line.str() << std::flush;
+  }
+
+  if (fStatusFile.empty()) return;
+
+  char updated[32];
+  const std::time_t t = std::time(nullptr);
+  std::strftime(updated, sizeof(updated), "%Y-%m-%dT%H:%M:%S", std::localtime(&t));
+
+  // written aside, then renamed: a reader never sees half a file
+  const std::string tmp = fStatusFile + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::trunc);
+    out << "{\"state\": \"" << (done ? "done" : "running") << "\", \"run\": " << gRunID
+        << ", \"events\": " << events << ", \"total\": " << gTotal
+        << ", \"events_per_s\": " << rate << ", \"events_per_s_avg\": " << average
+        << ", \"hits_per_s\": " << hitRate << ", \"mb_written\": " << mb
+        << ", \"elapsed_s\": " << elapsed << ", \"eta_s\": " << eta
+        << ", \"updated\": \"" << updated << "\"}\n";
+  }
+  std::rename(tmp.c_str(), fStatusFile.c_str());
+}
+
+} // namespace B3a
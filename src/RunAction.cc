@@ -1,24 +1,145 @@
 // RunAction.cc
 #include "RunAction.hh"
 #include "EventAction.hh"
+#include "ElectronTrackLibrary.hh"
+#include "StackingAction.hh"
+#include "PixelReadoutScorer.hh"
+#include "SteppingAction.hh"
+#include "Checkpoint.hh"
+#include "Histograms.hh"
+#include "ModulationCurve.hh"
+#include "Convergence.hh"
+#include "Timing.hh"
+#include "StepProfiler.hh"
+#include "HitBuffer.hh"
+#include "Progress.hh"
+#include "AdjointFlux.hh"
+#include "PrimaryGeneratorAction.hh"
 #include "G4Run.hh"
+#include "G4RunManager.hh"
+#include "G4AccumulableManager.hh"
 #include "G4Threading.hh"
 
+#include <cstdio>
+#include <fstream>
+
 // ROOT
 #include "TFile.h"
 #include "TTree.h"
 
 namespace B3a {
 
-void RunAction::BeginOfRunAction(const G4Run*)
+RunAction::RunAction()
+{
+  auto* accumulables = G4AccumulableManager::Instance();
+  accumulables->RegisterAccumulable(fNSteps);
+  accumulables->RegisterAccumulable(fNGasSteps);
+}
+
+void RunAction::BeginOfRunAction(const G4Run* run)
+{
+  if (IsMaster()) B3::StackingAction::ResetCounters();
+  G4AccumulableManager::Instance()->Reset();
+
+  fRunID = run->GetRunID();
+  if (IsMaster()) Checkpoint::StartRun(fRunID, fOutputDir);
+  if (IsMaster()) B3::ElectronTrackLibrary::Instance().CheckGas();   // /B3/det/ may have changed
+  fDone.clear();
+  fPending.clear();
+  fSinceCheckpoint = 0;
+
+  fChunk = 0;
+  if (IsRotating() && !IsMaster()) {
+    std::ofstream index(FileBase() + "_index.txt", std::ios::trunc);
+    index << "# file nEvents firstEventID lastEventID bytes\n";
+  }
+
+  const auto* generator = dynamic_cast<const B3::PrimaryGeneratorAction*>(
+      G4RunManager::GetRunManager()->GetUserPrimaryGeneratorAction());
+  ModulationCurve::BeginOfRun(generator && generator->IsPolarized());
+  Convergence::BeginOfRun();
+  Timing::BeginOfRun();
+  StepProfiler::BeginOfRun();
+  HitBuffer::BeginOfRun();
+  AdjointFlux::BeginOfRun();
+  if (IsMaster()) Progress::BeginOfRun(fRunID, run->GetNumberOfEventToBeProcessed());
+
+  Histograms::BeginOfRun(fOutputDir);
+  OpenOutput();
+}
+
+void RunAction::EndOfRunAction(const G4Run*)
+{
+  CloseOutput();   // also the last checkpoint: --resume skips a complete run
+  Histograms::EndOfRun();
+  ModulationCurve::EndOfRun(fRunID, fOutputDir);   // workers hand over, the master fits
+  Convergence::EndOfRun();
+
+  // workers have handed over their tracks by now
+  auto& library = B3::ElectronTrackLibrary::Instance();
+  if (IsMaster() && library.IsRecording()) library.Save();
+
+  if (IsMaster()) B3::StackingAction::PrintKillSummary();
+
+  G4AccumulableManager::Instance()->Merge();
+  if (IsMaster() && SteppingAction::IsEnabled()) {
+    G4cout << "---- Steps: " << fNSteps.GetValue() << " in total, "
+           << fNGasSteps.GetValue() << " in the gas ----" << G4endl;
+  }
+
+  Timing::EndOfRun(fRunID);   // after CloseOutput: includes the file close
+  StepProfiler::EndOfRun();
+  HitBuffer::EndOfRun(fRunID);
+  AdjointFlux::EndOfRun(fRunID, fOutputDir);
+  if (IsMaster()) Progress::EndOfRun();
+}
+
+std::string RunAction::FileBase() const
 {
   int tid = G4Threading::G4GetThreadId();  // -1 on master
-  std::string fname = (tid < 0)
-    ? "tpc_hits_master.root"
-    : ("tpc_hits_t" + std::to_string(tid) + ".root");
+  std::string base = (tid < 0)
+    ? "tpc_hits_master"
+    : ("tpc_hits_t" + std::to_string(tid));
+  if (Checkpoint::Attempt() > 0) base += "_r" + std::to_string(Checkpoint::Attempt());
+
+  if (!fOutputDir.empty()) base = fOutputDir + "/" + base;
+  return base;
+}
+
+void RunAction::OpenOutput()
+{
+  if (Histograms::IsOnly() || AdjointFlux::IsRunning()) return;
+
+  fChunkFile = FileBase();
+  if (IsRotating() && !IsMaster()) {
+    char chunk[16];
+    std::snprintf(chunk, sizeof(chunk), "_%04d", fChunk);
+    fChunkFile += chunk;
+  }
+  fChunkFile += ".root";
+  fChunkEvents = 0;
+  fChunkFirstEvent = fChunkLastEvent = -1;
+  fBytesReported = 0;
+
+  fOut  = TFile::Open(fChunkFile.c_str(), "RECREATE");
+
+  const auto& readout = B3::PixelReadoutScorer::GetSettings();
+  if (readout.enabled) {
+    fPixelTree = new TTree("pixels", "Readout pixels (energy per pixel and event)");
+    fPixelTree->Branch("eventID",      &pixels_.eventID);
+    fPixelTree->Branch("nRedpix",      &pixels_.nRedpix);
+    fPixelTree->Branch("redpix_ix",    &pixels_.redpix_ix);
+    fPixelTree->Branch("redpix_iy",    &pixels_.redpix_iy);
+    fPixelTree->Branch("redpix_iz",    &pixels_.redpix_iz);
+    fPixelTree->Branch("redpix_slice", &pixels_.redpix_slice);
+    if (Checkpoint::IsEnabled()) fPixelTree->SetAutoSave(0);   // only at checkpoints
+    if (!readout.writeSteps && !B3::ElectronTrackLibrary::Instance().IsRecording()) return;
+  }
 
-  fOut  = TFile::Open(fname.c_str(), "RECREATE");
   fTree = new TTree("steps", "Ionizing hits in gas");
+  // ROOT AutoSaves every 300 MB by default: entries on disk beyond the last
+  // .ckpt would be simulated again by --resume
+  if (Checkpoint::IsEnabled()) fTree->SetAutoSave(0);
 
   // ints
   fTree->Branch("eventID",   &cols_.eventID);
@@ -43,6 +164,7 @@ void RunAction::BeginOfRunAction(const G4Run*)
   fTree->Branch("px",&cols_.px); fTree->Branch("py",&cols_.py); fTree->Branch("pz",&cols_.pz);
   fTree->Branch("edep",&cols_.edep);
   fTree->Branch("stepLen",&cols_.stepLen);
+  fTree->Branch("weight", &cols_.weight);
 
   // NEW PE doubles
   fTree->Branch("pePx",   &cols_.pePx);
@@ -53,21 +175,106 @@ void RunAction::BeginOfRunAction(const G4Run*)
   fTree->Branch("pePhi",  &cols_.pePhi);
 }
 
-void RunAction::EndOfRunAction(const G4Run*)
+void RunAction::CloseOutput()
 {
-  if (fOut) {
+  if (!fOut) return;
+
+  Long64_t bytes = 0;
+  {
+    B3_TIME(kFileClose);
     fOut->Write();
+    bytes = fOut->GetSize();
     fOut->Close();
-    fOut = nullptr;
-    fTree = nullptr;
   }
+  B3_TIMING_CALL(Timing::AddBytes(bytes));
+  Progress::AddBytes(bytes - fBytesReported);
+  fBytesReported = 0;
+  delete fOut;
+  fOut = nullptr;
+  fTree = nullptr;
+  fPixelTree = nullptr;
+
+  // the chunk is complete: list it so that it can be picked up
+  if (IsRotating() && !IsMaster()) {
+    std::ofstream index(FileBase() + "_index.txt", std::ios::app);
+    index << fChunkFile << " " << fChunkEvents << " "
+          << fChunkFirstEvent << " " << fChunkLastEvent << " " << bytes << "\n";
+  }
+
+  CommitEvents();
 }
 
-void RunAction::FillFromSteps(const std::vector<EventAction::StepHit>& steps)
+void RunAction::SaveCheckpoint()
 {
+  if (!fOut) return;
+
+  // make what was filled so far readable after a crash
+  if (fTree)      fTree->AutoSave("SaveSelf");
+  if (fPixelTree) fPixelTree->AutoSave("SaveSelf");
+  fOut->Flush();
+
+  CommitEvents();
+}
+
+void RunAction::CommitEvents()
+{
+  fSinceCheckpoint = 0;
+  if (IsMaster() || !Checkpoint::IsEnabled()) return;
+
+  Checkpoint::Append(fDone, fPending);
+  fPending.clear();
+  Checkpoint::Write(FileBase() + "_run" + std::to_string(fRunID) + ".ckpt",
+                    fRunID, fChunkFile, fDone);
+}
+
+void RunAction::EndOfEvent(G4int eventID)
+{
+  if (!fOut) return;
+
+  if (fChunkEvents++ == 0) fChunkFirstEvent = eventID;
+  fChunkLastEvent = eventID;
+  Checkpoint::AddEvent(fPending, eventID);
+  ++fSinceCheckpoint;
+
+  if (Progress::IsEnabled()) {
+    const Long64_t written = fOut->GetBytesWritten();
+    Progress::AddBytes(written - fBytesReported);
+    fBytesReported = written;
+  }
+
+  const G4bool full = IsRotating() && (
+       (fRotateEvents > 0 && fChunkEvents >= fRotateEvents)
+    || (fRotateMB > 0. && fOut->GetBytesWritten() >= fRotateMB * 1024. * 1024.));
+  if (full) {
+    CloseOutput();
+    ++fChunk;
+    OpenOutput();
+  } else if (Checkpoint::GetInterval() > 0 && fSinceCheckpoint >= Checkpoint::GetInterval()) {
+    SaveCheckpoint();
+  }
+}
+
+void RunAction::FillFromSteps(const B3::GasHitsCollection& hits)
+{
+  if (!fTree) return;
+
+  B3_TIME(kFillFromSteps);
+  B3_TIMING_CALL(Timing::AddHits(hits.entries()));
   cols_.clear();
 
-  for (const auto& h : steps) {
+  const auto& all = *hits.GetVector();
+  const G4long maxHits = HitBuffer::GetMaxHits();
+  const G4bool coarsened = maxHits > 0 && G4long(all.size()) > maxHits
+                        && HitBuffer::GetPolicy() == HitBuffer::kCoarsen;
+  if (coarsened) {
+    HitBuffer::Coarsen(all, maxHits, coarse_);
+    HitBuffer::AddCoarsened(all.size(), coarse_.size());
+  }
+  const std::size_t n = coarsened ? coarse_.size() : all.size();
+
+  G4long entries = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto& h = coarsened ? coarse_[i] : *all[i];
     cols_.eventID.push_back(h.eventID);
     cols_.trackID.push_back(h.trackID);
     cols_.parentID.push_back(h.parentID);
@@ -84,6 +291,7 @@ void RunAction::FillFromSteps(const std::vector<EventAction::StepHit>& steps)
     cols_.pz.push_back(h.pz);
     cols_.edep.push_back(h.edep);
     cols_.stepLen.push_back(h.stepLen);
+    cols_.weight.push_back(h.weight);
 
     cols_.creatorType.push_back(h.creatorType);
     cols_.creatorSubType.push_back(h.creatorSubType);
@@ -100,9 +308,54 @@ void RunAction::FillFromSteps(const std::vector<EventAction::StepHit>& steps)
     cols_.peEkin.push_back(h.peEkin);
     cols_.peTheta.push_back(h.peTheta);
     cols_.pePhi.push_back(h.pePhi);
+
+    // spill: a full entry goes out, the event continues in the next one
+    if (maxHits > 0 && G4long(cols_.x.size()) >= maxHits && i + 1 < n) {
+      B3_TIME(kTreeFill);
+      fTree->Fill();
+      cols_.clear();
+      ++entries;
+    }
+  }
+  if (entries > 0) HitBuffer::AddSpill(entries);
+
+  B3_TIME(kTreeFill);
+  fTree->Fill();
+}
+
+G4double RunAction::BufferBytes()
+{
+  return G4double(cols_.bytes() + coarse_.capacity() * sizeof(B3::GasHit));
+}
+
+G4bool RunAction::ReleaseBuffers()
+{
+  const std::size_t keep = std::size_t(HitBuffer::GetKeepCapacity());
+  if (cols_.capacity() <= keep && coarse_.capacity() <= keep) return false;
+
+  cols_.release();
+  std::vector<B3::GasHit>().swap(coarse_);
+  return true;
+}
+
+void RunAction::FillPixels(G4int eventID, const G4THitsMap<G4double>& pixels)
+{
+  if (!fPixelTree) return;
+
+  pixels_.clear();
+  pixels_.eventID = eventID;
+  for (const auto& [index, edep] : *pixels.GetMap()) {
+    G4int ix, iy, iz;
+    B3::PixelReadoutScorer::Decode(index, ix, iy, iz);
+    pixels_.redpix_ix.push_back(ix);
+    pixels_.redpix_iy.push_back(iy);
+    pixels_.redpix_slice.push_back(iz);
+    pixels_.redpix_iz.push_back(float(*edep/CLHEP::keV));
   }
+  pixels_.nRedpix = int(pixels_.redpix_ix.size());
 
-  if (fTree) fTree->Fill();
+  B3_TIME(kTreeFill);
+  fPixelTree->Fill();
 }
 
 } // namespace B3a
@@ -1,19 +1,353 @@
 /// \file B3/B3a/src/StackingAction.cc
 #include "StackingAction.hh"
+#include "StackingMessenger.hh"
 
 #include "G4Track.hh"
-#include "G4NeutrinoE.hh"
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4AutoLock.hh"
+#include "G4Exception.hh"
+#include "G4EventManager.hh"
+#include "G4RunManager.hh"
+#include "G4StackManager.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4VSolid.hh"
+
+#include "EventAction.hh"
+
+#include <algorithm>
 
 namespace B3 {
 
+namespace {
+  // every StackingAction (one per worker) so the master can sum them
+  G4Mutex gRegistryMutex = G4MUTEX_INITIALIZER;
+  std::vector<StackingAction*> gRegistry;
+
+  const char* kReasonName[] = {"species", "min energy", "time cut", "cannot reach gas"};
+
+  G4int PDGOf(const G4String& particle)
+  {
+    const auto* def = G4ParticleTable::GetParticleTable()->FindParticle(particle);
+    if (!def) {
+      G4Exception("StackingAction", "B3_UNKNOWN_PARTICLE", JustWarning,
+                  ("Unknown particle name " + particle + "; ignored.").c_str());
+      return 0;
+    }
+    return def->GetPDGEncoding();
+  }
+
+  G4String RegionName(const G4String& alias)
+  {
+    if (alias == "world") return "DefaultRegionForTheWorld";
+    if (alias == "gas")   return "TPCGasRegion";
+    return alias;
+  }
+}
+
+StackingAction::StackingAction()
+{
+  // Kill neutrinos to save time (all flavours)
+  fKillPDG = {12, -12, 14, -14, 16, -16};
+
+  fMessenger = new StackingMessenger(this);
+
+  G4AutoLock lock(&gRegistryMutex);
+  gRegistry.push_back(this);
+}
+
+StackingAction::~StackingAction()
+{
+  {
+    G4AutoLock lock(&gRegistryMutex);
+    gRegistry.erase(std::remove(gRegistry.begin(), gRegistry.end(), this),
+                    gRegistry.end());
+  }
+  delete fMessenger;
+}
+
 G4ClassificationOfNewTrack
 StackingAction::ClassifyNewTrack(const G4Track* track)
 {
-  // Keep primaries and all secondaries by default
-  // Kill neutrinos to save time
-  if (track->GetDefinition() == G4NeutrinoE::NeutrinoE()) return fKill;
+  if (fReclassifying) return Reclassify(track);
+
+  ++fSeen;
+  const G4int pdg = track->GetDefinition()->GetPDGEncoding();
+
+  if (fKillPDG.count(pdg)) return Killed(track, kSpecies);
+
+  if (fTimeCut > 0. && track->GetGlobalTime() > fTimeCut) {
+    return Killed(track, kTimeCut);
+  }
+
+  const G4bool secondary = (track->GetParentID() > 0);
 
+  // region of creation: secondaries carry the touchable of their parent
+  if (secondary && !fMinEnergy.empty()) {
+    if (!fRegionsResolved) ResolveRegions();
+    const auto* pv = track->GetVolume();
+    const G4Region* region = pv ? pv->GetLogicalVolume()->GetRegion() : nullptr;
+    const G4double ekin = track->GetKineticEnergy();
+    for (const auto& rule : fMinEnergy) {
+      if (rule.resolved == region && (rule.pdg == 0 || rule.pdg == pdg)
+          && ekin < rule.minEkin) {
+        return Killed(track, kMinEnergy);
+      }
+    }
+  }
+
+  if (secondary && fDeferPDG.count(pdg)) {
+    ++fDeferred;
+    return fWaiting;
+  }
+
+  // stage 0 of the early-abort scheme: primaries and direct products only
+  if (fEarlyAbort && fStage == 0) {
+    if (!secondary) {
+      fPrimaryIDs.push_back(track->GetTrackID());
+    } else if (std::find(fPrimaryIDs.begin(), fPrimaryIDs.end(),
+                         track->GetParentID()) == fPrimaryIDs.end()) {
+      return fWaiting;
+    }
+  }
+
+  // Keep primaries and all other secondaries
   return fUrgent;
 }
 
+// --------------------------------------------------
+// Early abort: called once the first stage is done. The waiting tracks
+// have been moved to the urgent stack and go through Reclassify().
+// --------------------------------------------------
+void StackingAction::NewStage()
+{
+  if (!fEarlyAbort || fStage > 0) return;
+  fStage = 1;
+
+  fGasHit        = GasReached();
+  fNReachable    = 0;
+  fReclassifying = true;
+  stackManager->ReClassify();
+  fReclassifying = false;
+
+  if (!fGasHit && fNReachable == 0) {
+    ++fEarlyAborted;
+    // marks the event as aborted too, so EventAction does not write it
+    G4RunManager::GetRunManager()->AbortEvent();
+  }
+}
+
+G4ClassificationOfNewTrack
+StackingAction::Reclassify(const G4Track* track)
+{
+  if (fGasHit || CanReachGas(track)) {
+    ++fNReachable;
+    return fUrgent;
+  }
+  return Killed(track, kUnreachable);
+}
+
+G4bool StackingAction::GasReached() const
+{
+  const auto* ea = dynamic_cast<const B3a::EventAction*>(
+      G4EventManager::GetEventManager()->GetUserEventAction());
+  return !ea || ea->totalEdepGas() > 0.;
+}
+
+G4bool StackingAction::CanReachGas(const G4Track* track) const
+{
+  const G4double ekin = track->GetKineticEnergy();
+  if (fReachMinEnergy > 0. && ekin < fReachMinEnergy) return false;
+
+  // an unstable particle can decay anywhere, in any direction
+  if (fReachKeepUnstable && !track->GetDefinition()->GetPDGStable()) return true;
+
+  if (!fGasSolid) return true;
+
+  const G4ThreeVector p = fToGas.TransformPoint(track->GetPosition());
+  if (fGasSolid->Inside(p) != kOutside) return true;
+  if (ekin <= 0.) return false;
+
+  // the world is vacuum without field: straight lines
+  const G4ThreeVector d = fToGas.TransformAxis(track->GetMomentumDirection());
+  return fGasSolid->DistanceToIn(p, d) != kInfinity;
+}
+
+G4ClassificationOfNewTrack
+StackingAction::Killed(const G4Track* track, KillReason reason)
+{
+  const G4double ekin = track->GetKineticEnergy();
+  fKilled[reason].n      += 1;
+  fKilled[reason].energy += ekin;
+  auto& byPDG = fKilledByPDG[track->GetDefinition()->GetPDGEncoding()];
+  byPDG.n      += 1;
+  byPDG.energy += ekin;
+  return fKill;
+}
+
+void StackingAction::PrepareNewEvent()
+{
+  if (!fRegionsResolved) ResolveRegions();
+
+  fStage = 0;
+  fGasHit = false;
+  fPrimaryIDs.clear();
+
+  if (fEarlyAbort) {
+    // looked up every event: the geometry may be rebuilt between runs
+    const auto* gasPV =
+      G4PhysicalVolumeStore::GetInstance()->GetVolume("TPCGas", false);
+    fGasSolid = gasPV ? gasPV->GetLogicalVolume()->GetSolid() : nullptr;
+    if (gasPV) {
+      fToGas = G4AffineTransform(gasPV->GetRotation(), gasPV->GetTranslation()).Inverse();
+    }
+  }
+}
+
+void StackingAction::ResolveRegions()
+{
+  auto* store = G4RegionStore::GetInstance();
+  for (auto& rule : fMinEnergy) {
+    rule.resolved = store->GetRegion(RegionName(rule.region), false);
+  }
+  fRegionsResolved = true;
+}
+
+// --------------------------------------------------
+// UI helpers
+// --------------------------------------------------
+void StackingAction::Kill(const G4String& particle, G4bool on)
+{
+  const G4int pdg = PDGOf(particle);
+  if (pdg == 0) return;
+  if (on) fKillPDG.insert(pdg);
+  else    fKillPDG.erase(pdg);
+}
+
+void StackingAction::Defer(const G4String& particle, G4bool on)
+{
+  const G4int pdg = PDGOf(particle);
+  if (pdg == 0) return;
+  if (on) fDeferPDG.insert(pdg);
+  else    fDeferPDG.erase(pdg);
+}
+
+void StackingAction::SetMinEnergy(const G4String& region, G4double e,
+                                  const G4String& particle)
+{
+  const G4int pdg = (particle == "all") ? 0 : PDGOf(particle);
+  if (pdg == 0 && particle != "all") return;
+
+  // replace an existing rule for the same region/species
+  fMinEnergy.erase(std::remove_if(fMinEnergy.begin(), fMinEnergy.end(),
+                     [&](const MinEnergyRule& r) {
+                       return r.region == region && r.pdg == pdg;
+                     }),
+                   fMinEnergy.end());
+  if (e > 0.) {
+    MinEnergyRule rule;
+    rule.region  = region;
+    rule.pdg     = pdg;
+    rule.minEkin = e;
+    fMinEnergy.push_back(rule);
+  }
+  fRegionsResolved = false;
+}
+
+void StackingAction::PrintPolicy() const
+{
+  auto name = [](G4int pdg) -> G4String {
+    const auto* def = G4ParticleTable::GetParticleTable()->FindParticle(pdg);
+    return def ? def->GetParticleName() : G4String(std::to_string(pdg));
+  };
+
+  G4cout << "\n---- Stacking policy (/B3/stack/) ----\n  kill :";
+  for (const auto pdg : fKillPDG) G4cout << " " << name(pdg);
+  G4cout << "\n  defer:";
+  for (const auto pdg : fDeferPDG) G4cout << " " << name(pdg);
+  G4cout << "\n";
+  for (const auto& r : fMinEnergy) {
+    G4cout << "  minEnergy " << r.region << " "
+           << (r.pdg ? name(r.pdg) : G4String("all")) << " : "
+           << G4BestUnit(r.minEkin, "Energy") << "\n";
+  }
+  if (fTimeCut > 0.) G4cout << "  timeCut : " << G4BestUnit(fTimeCut, "Time") << "\n";
+  if (fEarlyAbort) {
+    G4cout << "  earlyAbort : on, reach min energy "
+           << G4BestUnit(fReachMinEnergy, "Energy")
+           << (fReachKeepUnstable ? ", unstable kept" : "") << "\n";
+  }
+  G4cout << "--------------------------------------" << G4endl;
+}
+
+// --------------------------------------------------
+// Counters (master side, workers are idle when these are called)
+// --------------------------------------------------
+void StackingAction::ResetCounters()
+{
+  G4AutoLock lock(&gRegistryMutex);
+  for (auto* sa : gRegistry) {
+    sa->fKilled = {};
+    sa->fKilledByPDG.clear();
+    sa->fDeferred     = 0;
+    sa->fSeen         = 0;
+    sa->fEarlyAborted = 0;
+  }
+}
+
+void StackingAction::PrintKillSummary()
+{
+  std::array<KillCount, kNReasons> killed{};
+  std::unordered_map<G4int, KillCount> byPDG;
+  G4long deferred = 0, seen = 0, aborted = 0;
+  {
+    G4AutoLock lock(&gRegistryMutex);
+    for (const auto* sa : gRegistry) {
+      for (G4int r = 0; r < kNReasons; ++r) {
+        killed[r].n      += sa->fKilled[r].n;
+        killed[r].energy += sa->fKilled[r].energy;
+      }
+      for (const auto& [pdg, kc] : sa->fKilledByPDG) {
+        byPDG[pdg].n      += kc.n;
+        byPDG[pdg].energy += kc.energy;
+      }
+      deferred += sa->fDeferred;
+      seen     += sa->fSeen;
+      aborted  += sa->fEarlyAborted;
+    }
+  }
+  if (seen == 0) return;
+
+  G4long nKilled = 0;
+  for (const auto& kc : killed) nKilled += kc.n;
+
+  G4cout << "\n---- StackingAction: " << nKilled << " of " << seen
+         << " new tracks killed, " << deferred << " deferred ----" << G4endl;
+  if (aborted > 0) {
+    G4cout << "  events aborted early (nothing could reach the gas) : "
+           << aborted << G4endl;
+  }
+  for (G4int r = 0; r < kNReasons; ++r) {
+    if (killed[r].n == 0) continue;
+    G4cout << "  " << kReasonName[r] << " : " << killed[r].n << " tracks, "
+           << G4BestUnit(killed[r].energy, "Energy") << G4endl;
+  }
+
+  std::vector<std::pair<G4int, KillCount>> ranked(byPDG.begin(), byPDG.end());
+  std::sort(ranked.begin(), ranked.end(),
+            [](const auto& a, const auto& b) { return a.second.n > b.second.n; });
+  for (const auto& [pdg, kc] : ranked) {
+    const auto* def = G4ParticleTable::GetParticleTable()->FindParticle(pdg);
+    G4cout << "    " << (def ? def->GetParticleName() : G4String(std::to_string(pdg)))
+           << " : " << kc.n << G4endl;
+  }
+  G4cout << "------------------------------------------------------------" << G4endl;
+}
+
 } // namespace B3
@@ -0,0 +1,145 @@
+/// \file B3/B3a/src/StackingMessenger.cc
+
+#include "StackingMessenger.hh"
+#include "StackingAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithABool.hh"
+
+#include <sstream>
+
+namespace B3 {
+
+StackingMessenger::StackingMessenger(StackingAction* stacking)
+  : fAction(stacking)
+{
+  fDir = new G4UIdirectory("/B3/stack/");
+  fDir->SetGuidance("Classification policy for new tracks");
+
+  auto makeParticleCmd = [this](const char* path, const char* guidance) {
+    auto* cmd = new G4UIcmdWithAString(path, this);
+    cmd->SetGuidance(guidance);
+    cmd->SetParameterName("particle", false);
+    return cmd;
+  };
+  fKillCmd    = makeParticleCmd("/B3/stack/kill",
+                                "Kill every new track of this species (neutrinos by default)");
+  fKeepCmd    = makeParticleCmd("/B3/stack/keep",
+                                "Remove a species from the kill list");
+  fDeferCmd   = makeParticleCmd("/B3/stack/defer",
+                                "Send secondaries of this species to the waiting stack");
+  fUndeferCmd = makeParticleCmd("/B3/stack/undefer",
+                                "Remove a species from the defer list");
+
+  fMinECmd = new G4UIcommand("/B3/stack/minEnergy", this);
+  fMinECmd->SetGuidance("Kill secondaries created in a region below an energy:");
+  fMinECmd->SetGuidance("  minEnergy <region> <value> <unit> [particle]");
+  fMinECmd->SetGuidance("region = world, gas or a G4Region name; value <= 0 removes the rule");
+  auto* pRegion = new G4UIparameter("region", 's', false);
+  auto* pValue  = new G4UIparameter("value", 'd', false);
+  auto* pUnit   = new G4UIparameter("unit", 's', true);
+  pUnit->SetDefaultValue("keV");
+  auto* pPart   = new G4UIparameter("particle", 's', true);
+  pPart->SetDefaultValue("all");
+  fMinECmd->SetParameter(pRegion);
+  fMinECmd->SetParameter(pValue);
+  fMinECmd->SetParameter(pUnit);
+  fMinECmd->SetParameter(pPart);
+
+  fTimeCutCmd = new G4UIcmdWithADoubleAndUnit("/B3/stack/timeCut", this);
+  fTimeCutCmd->SetGuidance("Kill tracks appearing later than this global time (<= 0: off)");
+  fTimeCutCmd->SetParameterName("t", false);
+  fTimeCutCmd->SetDefaultUnit("s");
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/B3/stack/print", this);
+  fPrintCmd->SetGuidance("Print the stacking policy");
+
+  fEarlyAbortCmd = new G4UIcmdWithABool("/B3/stack/earlyAbort", this);
+  fEarlyAbortCmd->SetGuidance("Track primaries and their direct products first; if nothing");
+  fEarlyAbortCmd->SetGuidance("has reached the gas by then and no waiting track can, abort");
+  fEarlyAbortCmd->SetGuidance("the event (it is counted but not written)");
+  fEarlyAbortCmd->SetParameterName("on", true);
+  fEarlyAbortCmd->SetDefaultValue(true);
+
+  fReachMinECmd = new G4UIcmdWithADoubleAndUnit("/B3/stack/reachMinEnergy", this);
+  fReachMinECmd->SetGuidance("Early abort: waiting tracks below this energy cannot reach the gas");
+  fReachMinECmd->SetParameterName("e", false);
+  fReachMinECmd->SetDefaultUnit("keV");
+
+  fReachUnstableCmd = new G4UIcmdWithABool("/B3/stack/reachKeepUnstable", this);
+  fReachUnstableCmd->SetGuidance("Early abort: always keep unstable particles (default true),");
+  fReachUnstableCmd->SetGuidance("their decay products can go anywhere");
+  fReachUnstableCmd->SetParameterName("on", true);
+  fReachUnstableCmd->SetDefaultValue(true);
+}
+
+StackingMessenger::~StackingMessenger()
+{
+  delete fKillCmd;
+  delete fKeepCmd;
+  delete fDeferCmd;
+  delete fUndeferCmd;
+  delete fMinECmd;
+  delete fTimeCutCmd;
+  delete fPrintCmd;
+  delete fEarlyAbortCmd;
+  delete fReachMinECmd;
+  delete fReachUnstableCmd;
+  delete fDir;
+}
+
+void StackingMessenger::SetNewValue(G4UIcommand* cmd, G4String value)
+{
+  if (cmd == fKillCmd) {
+
+    fAction->Kill(value, true);
+
+  } else if (cmd == fKeepCmd) {
+
+    fAction->Kill(value, false);
+
+  } else if (cmd == fDeferCmd) {
+
+    fAction->Defer(value, true);
+
+  } else if (cmd == fUndeferCmd) {
+
+    fAction->Defer(value, false);
+
+  } else if (cmd == fMinECmd) {
+
+    std::istringstream is(value);
+    G4String region, unit, particle;
+    G4double v;
+    is >> region >> v >> unit >> particle;
+    fAction->SetMinEnergy(region, v*G4UIcommand::ValueOf(unit), particle);
+
+  } else if (cmd == fTimeCutCmd) {
+
+    fAction->SetTimeCut(fTimeCutCmd->GetNewDoubleValue(value));
+
+  } else if (cmd == fPrintCmd) {
+
+    fAction->PrintPolicy();
+
+  } else if (cmd == fEarlyAbortCmd) {
+
+    fAction->SetEarlyAbort(fEarlyAbortCmd->GetNewBoolValue(value));
+
+  } else if (cmd == fReachMinECmd) {
+
+    fAction->SetReachMinEnergy(fReachMinECmd->GetNewDoubleValue(value));
+
+  } else if (cmd == fReachUnstableCmd) {
+
+    fAction->SetReachKeepUnstable(fReachUnstableCmd->GetNewBoolValue(value));
+
+  }
+}
+
+} // namespace B3
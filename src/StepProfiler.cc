@@ -0,0 +1,165 @@
+/// \file B3/B3a/src/StepProfiler.cc
+/// \brief Implementation of the B3a::StepProfiler class
+
+#include "StepProfiler.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4AutoLock.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace B3a {
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Table {
+  std::array<StepProfiler::Slot, StepProfiler::kCapacity> slots{};
+  StepProfiler::Slot overflow;
+  Clock::time_point  last;
+};
+
+G4ThreadLocal Table* local = nullptr;
+
+// master: merged rows, by (particle, process, volume) names
+struct Row { G4long steps = 0; G4double seconds = 0.; };
+using Key = std::tuple<std::string, std::string, std::string>;
+G4Mutex gProfileMutex = G4MUTEX_INITIALIZER;
+std::map<Key, Row> gMerged;
+
+inline std::size_t Hash(G4int pdg, G4int process, const G4LogicalVolume* lv)
+{
+  std::size_t h = std::size_t(reinterpret_cast<std::uintptr_t>(lv)) >> 4;
+  h ^= std::size_t(pdg) * 0x9E3779B97F4A7C15ull;
+  h ^= std::size_t(process) * 0xC2B2AE3D27D4EB4Full;
+  return (h ^ (h >> 29)) & (StepProfiler::kCapacity - 1);
+}
+}
+
+void StepProfiler::BeginOfRun()
+{
+  if (!fEnabled) return;
+
+  if (G4Threading::IsMasterThread()) {
+    G4AutoLock lock(&gProfileMutex);
+    gMerged.clear();
+  }
+  if (!local) local = new Table;
+  local->slots.fill(Slot());
+  local->overflow = Slot();
+  local->last = Clock::now();
+}
+
+void StepProfiler::BeginOfEvent()
+{
+  if (fEnabled && local) local->last = Clock::now();
+}
+
+void StepProfiler::Step(const G4Step* step)
+{
+  if (!local) return;
+
+  const auto now = Clock::now();
+  const G4double dt = std::chrono::duration<G4double>(now - local->last).count();
+  local->last = now;
+
+  const auto* definer = step->GetPostStepPoint()->GetProcessDefinedStep();
+  const G4int process = definer
+    ? (definer->GetProcessType() << 16 | definer->GetProcessSubType()) : -1;
+  const G4int pdg = step->GetTrack()->GetDefinition()->GetPDGEncoding();
+  const auto* pv = step->GetPreStepPoint()->GetPhysicalVolume();
+  const auto* lv = pv ? pv->GetLogicalVolume() : nullptr;
+
+  // linear probing; a full table books the step on the overflow row
+  Slot* slot = &local->overflow;
+  for (std::size_t i = Hash(pdg, process, lv), n = 0; n < kCapacity;
+       i = (i + 1) & (kCapacity - 1), ++n) {
+    auto& s = local->slots[i];
+    if (s.steps == 0) {
+      s.pdg = pdg; s.process = process; s.volume = lv; s.definer = definer;
+      slot = &s;
+      break;
+    }
+    if (s.pdg == pdg && s.process == process && s.volume == lv) {
+      slot = &s;
+      break;
+    }
+  }
+  slot->steps   += 1;
+  slot->seconds += dt;
+}
+
+void StepProfiler::EndOfRun()
+{
+  if (!fEnabled || !local) return;
+
+  // names while this thread's processes are alive
+  {
+    G4AutoLock lock(&gProfileMutex);
+    auto* particles = G4ParticleTable::GetParticleTable();
+    for (const auto& s : local->slots) {
+      if (s.steps == 0) continue;
+      const auto* def = particles->FindParticle(s.pdg);
+      const Key key(def ? std::string(def->GetParticleName()) : std::to_string(s.pdg),
+                    s.definer ? std::string(s.definer->GetProcessName()) : "none",
+                    s.volume ? std::string(s.volume->GetName()) : "none");
+      auto& row = gMerged[key];
+      row.steps   += s.steps;
+      row.seconds += s.seconds;
+    }
+    if (local->overflow.steps > 0) {
+      auto& row = gMerged[Key("(table full)", "", "")];
+      row.steps   += local->overflow.steps;
+      row.seconds += local->overflow.seconds;
+    }
+  }
+  if (!G4Threading::IsMasterThread()) return;
+
+  std::vector<std::pair<Key, Row>> rows(gMerged.begin(), gMerged.end());
+  G4long steps = 0;
+  G4double seconds = 0.;
+  for (const auto& [key, row] : rows) { steps += row.steps; seconds += row.seconds; }
+  if (steps == 0) return;
+
+  std::sort(rows.begin(), rows.end(),
+            [](const auto& a, const auto& b) { return a.second.seconds > b.second.seconds; });
+
+  G4cout << "\n---- Step profile: " << steps << " steps, " << seconds
+         << " s (all threads), top " << std::min<std::size_t>(fTop, rows.size())
+         << " of " << rows.size() << " by time ----\n"
+         << std::left << std::setw(14) << "  particle" << std::setw(22) << "process"
+         << std::setw(20) << "volume" << std::right
+         << std::setw(14) << "steps" << std::setw(8) << "%"
+         << std::setw(11) << "time [s]" << std::setw(8) << "%"
+         << std::setw(11) << "us/step" << G4endl;
+  for (std::size_t i = 0; i < rows.size() && i < std::size_t(fTop); ++i) {
+    const auto& [key, row] = rows[i];
+    G4cout << "  " << std::left << std::setw(12) << std::get<0>(key)
+           << std::setw(22) << std::get<1>(key) << std::setw(20) << std::get<2>(key)
+           << std::right << std::fixed
+           << std::setw(14) << row.steps
+           << std::setprecision(1) << std::setw(8) << 100. * row.steps / steps
+           << std::setprecision(3) << std::setw(11) << row.seconds
+           << std::setprecision(1) << std::setw(8) << (seconds > 0. ? 100. * row.seconds / seconds : 0.)
+           << std::setprecision(3) << std::setw(11) << 1e6 * row.seconds / row.steps
+           << std::defaultfloat << std::setprecision(6) << G4endl;
+  }
+  G4cout << "--------------------------------------" << G4endl;
+}
+
+} // namespace B3a
@@ -0,0 +1,191 @@
+/// \file B3/B3a/src/Timing.cc
+/// \brief Implementation of the B3a::Timing class
+
+#include "Timing.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Threading.hh"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace B3a {
+
+namespace {
+G4Mutex gTimingMutex = G4MUTEX_INITIALIZER;
+
+// this thread
+G4ThreadLocal Timing::Counters* local = nullptr;
+G4ThreadLocal Timing::Clock::time_point* runStart  = nullptr;
+G4ThreadLocal Timing::Clock::time_point* lastStep  = nullptr;
+
+// master: the threads of the current run (thread id, counters), and the
+// JSON records of the runs so far
+std::vector<std::pair<G4int, Timing::Counters>> gThreads;
+std::vector<std::string> gRunRecords;
+}
+
+G4bool Timing::IsCompiled()
+{
+#ifdef B3_TIMING
+  return true;
+#else
+  return false;
+#endif
+}
+
+const char* Timing::Name(Stage s)
+{
+  switch (s) {
+    case kGenerate:      return "generatePrimaries";
+    case kSteppingGas:   return "steppingGas";
+    case kSteppingOther: return "steppingOther";
+    case kEndOfEvent:    return "endOfEventAction";
+    case kFillFromSteps: return "fillFromSteps";
+    case kTreeFill:      return "treeFill";
+    case kFileClose:     return "fileClose";
+    default:             return "?";
+  }
+}
+
+void Timing::BeginOfRun()
+{
+  if (!fEnabled) return;
+
+  if (G4Threading::IsMasterThread()) {
+    G4AutoLock lock(&gTimingMutex);
+    gThreads.clear();
+  }
+  if (!local) {
+    local    = new Counters;
+    runStart = new Clock::time_point;
+    lastStep = new Clock::time_point;
+  }
+  *local = Counters();
+  *runStart = *lastStep = Clock::now();
+}
+
+void Timing::Add(Stage s, G4double seconds)
+{
+  if (!local) return;
+  local->seconds[s] += seconds;
+  local->calls[s]   += 1;
+}
+
+void Timing::BeginOfEvent()
+{
+  if (fEnabled && lastStep) *lastStep = Clock::now();
+}
+
+void Timing::EndOfEvent()
+{
+  if (fEnabled && local) local->events += 1;
+}
+
+void Timing::Step(G4bool inGas)
+{
+  if (!fEnabled || !lastStep) return;
+  const auto now = Clock::now();
+  Add(inGas ? kSteppingGas : kSteppingOther,
+      std::chrono::duration<G4double>(now - *lastStep).count());
+  *lastStep = now;
+}
+
+void Timing::AddHits(G4long n)
+{
+  if (fEnabled && local) local->hits += n;
+}
+
+void Timing::AddBytes(G4double n)
+{
+  if (fEnabled && local) local->bytes += n;
+}
+
+void Timing::Print(const char* label, const Counters& c)
+{
+  G4cout << "  " << std::left << std::setw(8) << label << std::right << std::fixed
+         << std::setw(9) << c.events
+         << std::setprecision(1) << std::setw(11) << (c.wall > 0. ? c.events / c.wall : 0.)
+         << std::setw(9) << (c.events > 0 ? G4double(c.hits) / c.events : 0.)
+         << std::setw(11) << (c.events > 0 ? c.bytes / c.events : 0.);
+  for (G4int s = 0; s < kNStages; ++s) G4cout << std::setprecision(3) << std::setw(10) << c.seconds[s];
+  G4cout << std::defaultfloat << std::setprecision(6) << G4endl;
+}
+
+std::string Timing::Json(const Counters& c)
+{
+  std::ostringstream os;
+  os << "{\"events\": " << c.events << ", \"wall_s\": " << c.wall
+     << ", \"events_per_s\": " << (c.wall > 0. ? c.events / c.wall : 0.)
+     << ", \"hits_per_event\": " << (c.events > 0 ? G4double(c.hits) / c.events : 0.)
+     << ", \"bytes_per_event\": " << (c.events > 0 ? c.bytes / c.events : 0.)
+     << ", \"stages\": {";
+  for (G4int s = 0; s < kNStages; ++s) {
+    os << (s ? ", " : "") << "\"" << Name(Stage(s)) << "\": {\"s\": " << c.seconds[s]
+       << ", \"calls\": " << c.calls[s] << "}";
+  }
+  os << "}}";
+  return os.str();
+}
+
+void Timing::EndOfRun(G4int runID)
+{
+  if (!fEnabled || !local) return;
+
+  local->wall = std::chrono::duration<G4double>(Clock::now() - *runStart).count();
+  {
+    G4AutoLock lock(&gTimingMutex);
+    gThreads.emplace_back(G4Threading::G4GetThreadId(), *local);
+  }
+  if (!G4Threading::IsMasterThread()) return;
+
+  // merged: sums over the threads, wall time of the master
+  Counters merged;
+  for (const auto& [tid, c] : gThreads) {
+    for (G4int s = 0; s < kNStages; ++s) {
+      merged.seconds[s] += c.seconds[s];
+      merged.calls[s]   += c.calls[s];
+    }
+    merged.events += c.events;
+    merged.hits   += c.hits;
+    merged.bytes  += c.bytes;
+  }
+  merged.wall = local->wall;
+
+  G4cout << "\n---- Timing (run " << runID << "), seconds per stage ----\n"
+         << "  thread     events   events/s  hits/ev   bytes/ev";
+  const char* columns[kNStages] = {"generate", "stepGas", "stepOther", "endEvent",
+                                   "fillSteps", "treeFill", "fileClose"};
+  for (const auto* col : columns) G4cout << std::setw(10) << col;
+  G4cout << G4endl;
+  for (const auto& [tid, c] : gThreads) {
+    Print(tid < 0 ? "master" : ("t" + std::to_string(tid)).c_str(), c);
+  }
+  Print("all", merged);
+  G4cout << "  (fillFromSteps includes its treeFill; all: events/s over the master wall time)\n"
+         << "--------------------------------------" << G4endl;
+
+  if (fJsonFile.empty()) return;
+
+  std::ostringstream run;
+  run << "{\"run\": " << runID << ", \"merged\": " << Json(merged) << ", \"threads\": [";
+  for (std::size_t i = 0; i < gThreads.size(); ++i) {
+    run << (i ? ", " : "") << "{\"thread\": " << gThreads[i].first << ", \"timing\": "
+        << Json(gThreads[i].second) << "}";
+  }
+  run << "]}";
+  gRunRecords.push_back(run.str());
+
+  // all the runs of the job so far
+  std::ofstream out(fJsonFile);
+  out << "{\"runs\": [\n";
+  for (std::size_t i = 0; i < gRunRecords.size(); ++i) {
+    out << "  " << gRunRecords[i] << (i + 1 < gRunRecords.size() ? ",\n" : "\n");
+  }
+  out << "]}\n";
+}
+
+} // namespace B3a